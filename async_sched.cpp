@@ -0,0 +1,292 @@
+#include "async_sched.h"
+#include "watchdog.h"
+#include <lua.hpp>
+#include <cmath>
+#include <cstdio>
+
+struct AsyncCoroutine {
+    lua_State* co = nullptr;
+    int ref = LUA_NOREF;         // 코루틴 스레드가 GC 되지 않게 레지스트리에 잡아 둠
+    uint64_t id = 0;
+    bool parked = false;         // await/sleep/nextFrame으로 스스로 대기 등록함
+    bool running = false;        // lua_resume 안 (중첩 sys.async로 자식을 돌리는 중 포함)
+    bool cancelled = false;      // 실행 중에 취소됨 -> 다음 양보 때 닫음
+
+    // AsyncWaitable::waiters 연결
+    AsyncCoroutine* prev = nullptr;
+    AsyncCoroutine* next = nullptr;
+    AsyncWaitable* waitingOn = nullptr;
+
+    uint64_t wakeTick = 0;       // 타이머 휠 틱
+};
+
+AsyncWaitable::~AsyncWaitable() {
+    for (AsyncCoroutine* ac = waiters; ac; ac = ac->next) ac->waitingOn = nullptr;
+}
+
+static void LinkWaiter(AsyncWaitable& waitable, AsyncCoroutine* ac) {
+    ac->waitingOn = &waitable;
+    ac->prev = nullptr;
+    ac->next = waitable.waiters;
+    if (waitable.waiters) waitable.waiters->prev = ac;
+    waitable.waiters = ac;
+}
+
+static void UnlinkWaiter(AsyncCoroutine* ac) {
+    if (!ac->waitingOn) return;
+    if (ac->prev) ac->prev->next = ac->next;
+    else ac->waitingOn->waiters = ac->next;
+    if (ac->next) ac->next->prev = ac->prev;
+    ac->prev = ac->next = nullptr;
+    ac->waitingOn = nullptr;
+}
+
+static lua_State* MainThreadOf(lua_State* L) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    lua_State* main = lua_tothread(L, -1);
+    lua_pop(L, 1);
+    return main;
+}
+
+// 양보 중인 코루틴을 닫아서 to-be-closed 변수(<close>)를 정리합니다.
+static void CloseThread(lua_State* co, lua_State* from) {
+#if LUA_VERSION_NUM > 504 || (defined(LUA_VERSION_RELEASE_NUM) && LUA_VERSION_RELEASE_NUM >= 50406)
+    int status = lua_closethread(co, from);
+#else
+    (void)from;
+    int status = lua_resetthread(co);
+#endif
+    if (status != LUA_OK) printf("[LUA ERROR] async cancel: %s\n", lua_tostring(co, -1));
+}
+
+AsyncScheduler::AsyncScheduler() = default;
+AsyncScheduler::~AsyncScheduler() = default;
+
+AsyncCoroutine* AsyncScheduler::Find(Handle h) const {
+    auto it = coroutines.find(h.co);
+    return it != coroutines.end() && it->second->id == h.id ? it->second.get() : nullptr;
+}
+
+AsyncCoroutine* AsyncScheduler::Current(lua_State* L) const {
+    if (!lua_isyieldable(L)) return nullptr;
+    auto it = coroutines.find(L);
+    return it == coroutines.end() ? nullptr : it->second.get();
+}
+
+void AsyncScheduler::Finish(AsyncCoroutine* ac) {
+    UnlinkWaiter(ac);
+    luaL_unref(mainThread, LUA_REGISTRYINDEX, ac->ref);
+    coroutines.erase(ac->co);
+}
+
+// 코루틴 스택에 nargs개의 인자가 올라가 있는 상태에서 호출
+// from: 재개를 요청한 스레드 (다른 코루틴 안에서 sys.async를 부른 경우 그 코루틴)
+void AsyncScheduler::Resume(AsyncCoroutine* ac, int nargs, lua_State* from) {
+    ac->parked = false;
+    ac->running = true;
+    int nres = 0;
+    int status;
+    {
+        HitchRunningThread running(ac->co); // 멈추면 이 코루틴의 스택을 잡도록
+        status = lua_resume(ac->co, from, nargs, &nres);
+    }
+    ac->running = false;
+
+    if (status == LUA_YIELD) {
+        lua_pop(ac->co, nres);
+        if (ac->cancelled) {
+            CloseThread(ac->co, from);
+            Finish(ac);
+        }
+        // 그냥 coroutine.yield() 한 경우는 다음 프레임에 이어서 실행
+        else if (!ac->parked) {
+            nextFrame.push_back({ ac->co, ac->id });
+        }
+        return;
+    }
+    if (status != LUA_OK) {
+        luaL_traceback(ac->co, ac->co, lua_tostring(ac->co, -1), 0);
+        printf("[LUA ERROR] async: %s\n", lua_tostring(ac->co, -1));
+    }
+    Finish(ac);
+}
+
+int AsyncScheduler::Spawn(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    const int n = lua_gettop(L);
+    luaL_checkstack(L, n + 2, nullptr);
+    if (!mainThread) mainThread = MainThreadOf(L);
+
+    // 참조는 레지스트리에 직접 걸고 메인 스레드로 풉니다.
+    // L이 코루틴이면 자식보다 먼저 끝나서 수거될 수 있으므로 L에 묶어 두면 안 됩니다.
+    lua_State* co = lua_newthread(L);
+    lua_pushvalue(L, -1);
+    auto ac = std::make_unique<AsyncCoroutine>();
+    ac->co = co;
+    ac->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    ac->id = nextId++;
+
+    // 함수와 인자를 코루틴 스택으로 복사 (L 스택 맨 위에는 반환할 코루틴이 남음)
+    for (int i = 1; i <= n; i++) lua_pushvalue(L, i);
+    lua_xmove(L, co, n);
+
+    AsyncCoroutine* raw = ac.get();
+    coroutines[co] = std::move(ac);
+    Resume(raw, n - 1, L);
+    return 1;
+}
+
+int AsyncScheduler::Cancel(lua_State* L, int idx) {
+    lua_State* co = lua_tothread(L, idx);
+    auto it = co ? coroutines.find(co) : coroutines.end();
+    if (it == coroutines.end()) {
+        lua_pushboolean(L, 0); // 이미 끝났거나 sys.async 코루틴이 아님
+        return 1;
+    }
+
+    AsyncCoroutine* ac = it->second.get();
+    if (ac->running) {
+        // 자기 자신이나, 중첩 sys.async로 지금 이 코드를 실행 중인 부모는 바로 닫을 수 없음
+        ac->cancelled = true;
+    }
+    else {
+        // 대기 목록(nextFrame, 타이머 휠)에 남은 핸들은 Find에서 걸러집니다.
+        CloseThread(ac->co, L);
+        Finish(ac);
+    }
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+// 이미 끝났으면 양보하지 않고 바로 결과를 돌려줍니다.
+int AsyncScheduler::Await(lua_State* L, AsyncWaitable& waitable) {
+    if (waitable.Ready(MainThreadOf(L))) {
+        waitable.PushResult(L);
+        return 1;
+    }
+
+    AsyncCoroutine* ac = Current(L);
+    if (!ac) return luaL_error(L, "task:await() must be called inside sys.async");
+
+    LinkWaiter(waitable, ac);
+    ac->parked = true;
+    return lua_yield(L, 0);
+}
+
+int AsyncScheduler::NextFrame(lua_State* L) {
+    AsyncCoroutine* ac = Current(L);
+    if (!ac) return luaL_error(L, "sys.nextFrame() must be called inside sys.async");
+
+    nextFrame.push_back({ ac->co, ac->id });
+    ac->parked = true;
+    return lua_yield(L, 0);
+}
+
+int AsyncScheduler::Sleep(lua_State* L, double ms) {
+    AsyncCoroutine* ac = Current(L);
+    if (!ac) return luaL_error(L, "sys.sleep() must be called inside sys.async");
+
+    // 올림해서 넣어야 해당 칸을 처리할 때 시간이 지나 있음이 보장됩니다.
+    uint64_t tick = (uint64_t)ceil((nowMs + (ms > 0.0 ? ms : 0.0)) / kWheelTickMs);
+    if (tick <= wheelTick) {
+        nextFrame.push_back({ ac->co, ac->id });
+    }
+    else {
+        ac->wakeTick = tick;
+        wheel[tick % kWheelSlots].push_back({ ac->co, ac->id });
+    }
+    ac->parked = true;
+    return lua_yield(L, 0);
+}
+
+void AsyncScheduler::Notify(std::weak_ptr<AsyncWaitable> waitable) {
+    std::lock_guard<std::mutex> lock(readyMutex);
+    ready.push_back(std::move(waitable));
+}
+
+void AsyncScheduler::Tick(double dtms) {
+    nowMs += dtms;
+
+    // 1. 이번 프레임에 깨울 대상을 재개 전에 확정합니다. 아래에서 재개된 코루틴이 다시
+    //    sys.nextFrame / coroutine.yield / sys.sleep(0)을 부르면 다음 Tick으로 넘어가야 하므로
+    //    nextFrame 목록과 타이머 휠의 칸 범위를 먼저 떼어 둡니다.
+    std::vector<Handle> frame;
+    frame.swap(nextFrame);
+
+    // 오래 멈췄으면 휠은 한 바퀴만 돌면 충분
+    const uint64_t nowTick = (uint64_t)(nowMs / kWheelTickMs);
+    uint64_t from = wheelTick + 1;
+    if (nowTick >= kWheelSlots && from + kWheelSlots <= nowTick) from = nowTick - kWheelSlots + 1;
+    wheelTick = nowTick;
+
+    std::vector<Handle> due;
+    for (uint64_t t = from; t <= nowTick; t++) {
+        auto& slot = wheel[t % kWheelSlots];
+        for (size_t i = 0; i < slot.size();) {
+            AsyncCoroutine* ac = Find(slot[i]);
+            if (!ac || ac->wakeTick <= nowTick) {
+                if (ac) due.push_back(slot[i]);
+                slot[i] = slot.back();
+                slot.pop_back();
+            }
+            else {
+                i++;
+            }
+        }
+    }
+
+    // 2. 완료 통지된 대상의 대기 코루틴 재개 (결과는 메인 스레드에 한 번 올려서 나눠 줌)
+    std::vector<std::weak_ptr<AsyncWaitable>> done;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        done.swap(ready);
+    }
+    for (auto& weak : done) {
+        std::shared_ptr<AsyncWaitable> waitable = weak.lock();
+        if (!waitable || !waitable->waiters) continue;
+        if (!waitable->Ready(mainThread)) continue;
+
+        lua_checkstack(mainThread, 2);
+        waitable->PushResult(mainThread);
+        while (AsyncCoroutine* ac = waitable->waiters) {
+            UnlinkWaiter(ac);
+            lua_pushvalue(mainThread, -1);
+            lua_xmove(mainThread, ac->co, 1);
+            Resume(ac, 1, mainThread);
+        }
+        lua_pop(mainThread, 1);
+    }
+
+    // 3. nextFrame 대기, 4. 시간이 된 sleep (1에서 떼어 둔 것만)
+    for (Handle h : frame) {
+        if (AsyncCoroutine* ac = Find(h)) Resume(ac, 0, mainThread);
+    }
+    for (Handle h : due) {
+        if (AsyncCoroutine* ac = Find(h)) Resume(ac, 0, mainThread);
+    }
+}
+
+void AsyncScheduler::Reset() {
+    for (auto& [co, ac] : coroutines) {
+        UnlinkWaiter(ac.get());
+        luaL_unref(mainThread, LUA_REGISTRYINDEX, ac->ref);
+    }
+    coroutines.clear();
+    nextFrame.clear();
+    for (auto& slot : wheel) slot.clear();
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        ready.clear();
+    }
+    mainThread = nullptr;
+    nowMs = 0.0;
+    wheelTick = 0;
+}
+
+size_t AsyncScheduler::AwaitingCount() const {
+    size_t n = 0;
+    for (const auto& [co, ac] : coroutines) {
+        if (ac->waitingOn) n++;
+    }
+    return n;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct lua_State;
+struct AsyncCoroutine;
+
+// 코루틴 기반 비동기 스케줄러 코어 (Lua C API만 사용, sol/Win32 의존성 없음)
+// sys.* 바인딩과 ITask 연결은 lua_async.cpp 에서 담당합니다.
+
+// await 할 수 있는 대상. 끝나면 아무 스레드에서나 AsyncScheduler::Notify를 부릅니다.
+struct AsyncWaitable {
+    virtual ~AsyncWaitable();
+    // 메인 스레드에서 호출. 끝났으면 true
+    virtual bool Ready(lua_State* L) = 0;
+    // 결과 값 하나를 L 스택에 올림 (대기 중인 코루틴 모두에게 같은 값을 나눠 줌)
+    virtual void PushResult(lua_State* L) = 0;
+
+    AsyncCoroutine* waiters = nullptr; // await 중인 코루틴 (침입형 리스트)
+};
+
+class AsyncScheduler {
+public:
+    AsyncScheduler();
+    ~AsyncScheduler();
+    AsyncScheduler(const AsyncScheduler&) = delete;
+    AsyncScheduler& operator=(const AsyncScheduler&) = delete;
+
+    // 아래 함수들은 lua_CFunction 본문으로 씁니다. (반환값은 Lua에 돌려줄 개수)
+
+    // 스택의 (fn, ...)으로 코루틴을 만들어 바로 실행하고 코루틴 자체를 돌려줌
+    int Spawn(lua_State* L);
+    // 대기 중이면 바로 닫고, 실행 중이면 다음 양보 때 닫음. 살아 있던 코루틴이면 true
+    int Cancel(lua_State* L, int idx);
+    int Await(lua_State* L, AsyncWaitable& waitable);
+    int NextFrame(lua_State* L);
+    int Sleep(lua_State* L, double ms);
+
+    // 작업 스레드에서 호출 가능
+    void Notify(std::weak_ptr<AsyncWaitable> waitable);
+
+    // 메인 스레드, 프레임마다: 완료 통지 -> nextFrame -> 타이머 순서로 재개
+    void Tick(double dtms);
+
+    // 상태를 닫기 전에 호출해야 코루틴 참조를 안전하게 풀 수 있습니다.
+    void Reset();
+
+    size_t Count() const { return coroutines.size(); }
+    size_t AwaitingCount() const;
+
+private:
+    // 코루틴 주소는 GC 뒤에 재사용될 수 있으므로 id까지 맞아야 같은 코루틴으로 봅니다.
+    struct Handle { lua_State* co; uint64_t id; };
+
+    AsyncCoroutine* Find(Handle h) const;
+    AsyncCoroutine* Current(lua_State* L) const;
+    void Resume(AsyncCoroutine* ac, int nargs, lua_State* from);
+    void Finish(AsyncCoroutine* ac);
+
+    lua_State* mainThread = nullptr; // 레지스트리 참조는 항상 메인 스레드로 풂
+    uint64_t nextId = 1;
+    std::unordered_map<lua_State*, std::unique_ptr<AsyncCoroutine>> coroutines;
+    std::vector<Handle> nextFrame;
+
+    std::mutex readyMutex;
+    std::vector<std::weak_ptr<AsyncWaitable>> ready;
+
+    // 타이머 휠: 16ms 틱 * 256 칸 = 한 바퀴 약 4초, 더 긴 대기는 wakeTick으로 걸러냅니다.
+    static constexpr double kWheelTickMs = 16.0;
+    static constexpr uint64_t kWheelSlots = 256;
+    std::vector<Handle> wheel[kWheelSlots];
+    double nowMs = 0.0;
+    uint64_t wheelTick = 0;
+};
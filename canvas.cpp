@@ -0,0 +1,79 @@
+#include "canvas.h"
+#include <algorithm>
+
+Canvas::~Canvas() {
+    if (owner) owner->Forget(this);
+}
+
+CanvasSet::~CanvasSet() {
+    // Lua가 아직 들고 있는 캔버스는 렌더 타깃만 버리고 연결을 끊습니다.
+    End();
+    for (Canvas* c : canvases) {
+        c->surface.reset();
+        c->owner = nullptr;
+    }
+}
+
+std::shared_ptr<Canvas> CanvasSet::Create(int w, int h, int imageId) {
+    auto c = std::make_shared<Canvas>();
+    c->width = w > 0 ? w : 1;
+    c->height = h > 0 ? h : 1;
+    c->imageId = imageId;
+    c->owner = this;
+    canvases.push_back(c.get());
+    return c;
+}
+
+bool CanvasSet::Begin(Canvas& c) {
+    End();
+    if (c.owner != this) return false;
+    if (!c.surface) {
+        c.surface = backend.CreateSurface(c);
+        if (!c.surface) return false;
+        c.dirty = true;
+    }
+
+    c.surface->Begin();
+    active = &c;
+    c.dirty = false;
+    if (onBegin) onBegin(c);
+    return true;
+}
+
+void CanvasSet::End() {
+    if (!active) return;
+    Canvas& c = *active;
+    if (onEnd) onEnd(c);
+    if (!c.surface->End()) c.dirty = true;
+    active = nullptr;
+}
+
+void CanvasSet::DeviceLost() {
+    End();
+    for (Canvas* c : canvases) {
+        c->surface.reset();
+        c->dirty = true;
+    }
+}
+
+size_t CanvasSet::Bytes() const {
+    size_t bytes = 0;
+    for (const Canvas* c : canvases) {
+        if (c->surface) bytes += c->surface->Bytes();
+    }
+    return bytes;
+}
+
+void CanvasSet::Forget(Canvas* c) {
+    if (active == c) End();
+    c->surface.reset();
+    canvases.erase(std::remove(canvases.begin(), canvases.end(), c), canvases.end());
+}
+
+void SoftwareCanvasSurface::FillRect(int x, int y, int w, int h, uint32_t argb) {
+    const int x0 = (std::max)(0, x), y0 = (std::max)(0, y);
+    const int x1 = (std::min)(width, x + w), y1 = (std::min)(height, y + h);
+    for (int row = y0; row < y1; row++) {
+        std::fill(pixels.begin() + (size_t)row * width + x0, pixels.begin() + (size_t)row * width + x1, argb);
+    }
+}
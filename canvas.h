@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// 오프스크린 캔버스 관리 (플랫폼 독립, D2D/Lua 의존성 없음)
+// 실제 렌더 타깃은 백엔드가 만들고(D2D는 lua_g.cpp, 테스트는 SoftwareCanvasBackend),
+// 여기서는 현재 대상 전환, 디바이스 손실 뒤 dirty 표시, 메모리 계산만 합니다.
+class CanvasSet;
+
+// 캔버스 하나의 렌더 타깃. 디바이스를 잃으면 통째로 버리고 다음 Begin 때 다시 만듭니다.
+struct CanvasSurface {
+    virtual ~CanvasSurface() = default;
+    virtual void Begin() = 0;
+    // 그리기 끝. 내용을 잃었으면(디바이스 손실) false
+    virtual bool End() = 0;
+    virtual size_t Bytes() const = 0;
+};
+
+struct Canvas;
+class CanvasBackend {
+public:
+    virtual ~CanvasBackend() = default;
+    // 실패하면 nullptr (Begin이 false를 돌려줌)
+    virtual std::unique_ptr<CanvasSurface> CreateSurface(const Canvas& canvas) = 0;
+};
+
+// 오프스크린 캔버스 (g.newCanvas)
+struct Canvas {
+    int width = 0, height = 0;
+    int imageId = -1;   // 엔진 이미지 슬롯. g.image(c.image, ...)로 그릴 수 있습니다.
+    bool dirty = true;  // 새로 만들었거나 디바이스 재생성으로 내용이 사라짐
+    std::unique_ptr<CanvasSurface> surface; // 처음 Begin 때 생성
+    CanvasSet* owner = nullptr;
+    ~Canvas();
+};
+
+class CanvasSet {
+public:
+    explicit CanvasSet(CanvasBackend& backend) : backend(backend) {}
+    ~CanvasSet();
+    CanvasSet(const CanvasSet&) = delete;
+    CanvasSet& operator=(const CanvasSet&) = delete;
+
+    // 크기는 1 이상으로 맞춥니다. 렌더 타깃은 아직 만들지 않음
+    std::shared_ptr<Canvas> Create(int w, int h, int imageId);
+
+    // 현재 캔버스를 끝내고 c에 그리기 시작. 렌더 타깃을 (다시) 만들었으면 dirty가 true로 남고,
+    // 성공하면 이번에 다시 그린다는 뜻으로 dirty를 지웁니다. 실패하면 false (화면에 그리는 상태)
+    bool Begin(Canvas& c);
+    // 현재 캔버스에 그리기 끝. 내용을 잃었으면 dirty
+    void End();
+    Canvas* Active() const { return active; }
+
+    // Begin 직후/End 직전에 엔진이 그리기 상태를 바꿀 수 있도록 (End 훅은 아직 active가 남아 있을 때 호출)
+    std::function<void(Canvas&)> onBegin, onEnd;
+
+    // 디바이스 손실: 모든 렌더 타깃을 버리고 dirty 표시
+    void DeviceLost();
+
+    size_t Count() const { return canvases.size(); }
+    size_t Bytes() const; // 렌더 타깃이 있는 캔버스만
+    const std::vector<Canvas*>& All() const { return canvases; }
+
+private:
+    friend struct Canvas;
+    void Forget(Canvas* c);
+
+    CanvasBackend& backend;
+    std::vector<Canvas*> canvases;
+    Canvas* active = nullptr;
+};
+
+// 캔버스에 그리는 동안 메인 대상의 그리기 상태(변환/클립 등)를 보관합니다.
+template <class State>
+struct CanvasStateSwap {
+    State saved;
+    void Enter(State& current) {
+        saved = std::move(current);
+        current = State();
+    }
+    void Leave(State& current) {
+        current = std::move(saved);
+        saved = State();
+    }
+};
+
+// CPU 백엔드: BGRA(premultiplied) 픽셀 버퍼. 테스트와 헤드리스 실행용
+struct SoftwareCanvasSurface : CanvasSurface {
+    int width, height;
+    std::vector<uint32_t> pixels;
+    bool drawing = false;
+    bool lost = false; // 다음 End에서 디바이스 손실을 흉내 냄
+
+    SoftwareCanvasSurface(int w, int h) : width(w), height(h), pixels((size_t)w * h, 0) {}
+    void Begin() override { drawing = true; }
+    bool End() override {
+        drawing = false;
+        return !lost;
+    }
+    size_t Bytes() const override { return pixels.size() * sizeof(uint32_t); }
+
+    void Clear(uint32_t argb) { std::fill(pixels.begin(), pixels.end(), argb); }
+    // 캔버스 밖은 잘라냄
+    void FillRect(int x, int y, int w, int h, uint32_t argb);
+    uint32_t Pixel(int x, int y) const { return pixels[(size_t)y * width + x]; }
+};
+
+class SoftwareCanvasBackend : public CanvasBackend {
+public:
+    std::unique_ptr<CanvasSurface> CreateSurface(const Canvas& canvas) override {
+        created++;
+        return std::make_unique<SoftwareCanvasSurface>(canvas.width, canvas.height);
+    }
+    int created = 0;
+};
@@ -0,0 +1,60 @@
+#include "gc_schedule.h"
+#include <algorithm>
+#include <lua.hpp>
+
+const char* GcModeName(const GcSchedule& gc) {
+    return gc.enabled ? (gc.generational ? "generational" : "incremental") : "auto";
+}
+
+bool SetGcMode(lua_State* L, GcSchedule& gc, std::string_view mode) {
+    if (mode == "auto") {
+        gc.enabled = false;
+        lua_gc(L, LUA_GCINC, 0, 0, 0);
+        lua_gc(L, LUA_GCRESTART);
+        return true;
+    }
+    if (mode != "incremental" && mode != "generational") return false;
+
+    gc.enabled = true;
+    gc.generational = (mode == "generational");
+    if (gc.generational) lua_gc(L, LUA_GCGEN, 0, 0);
+    else lua_gc(L, LUA_GCINC, 0, 0, 0);
+    lua_gc(L, LUA_GCSTOP); // 이후로는 RunScheduledGC만 수집을 진행
+    gc.lastCycleKB = (size_t)lua_gc(L, LUA_GCCOUNT);
+    return true;
+}
+
+void RunScheduledGC(lua_State* L, GcSchedule& gc, double slackMs, double (*nowMs)()) {
+    if (!gc.enabled) return;
+
+    const double window = (std::min)((std::max)(slackMs, 0.0), gc.budgetMs);
+    const size_t heapKB = (size_t)lua_gc(L, LUA_GCCOUNT);
+
+    // 남는 시간이 계속 없어서 힙이 너무 커지면 예산을 넘기더라도 사이클을 끝냅니다.
+    const bool forced = heapKB > gc.lastCycleKB * 2 + 1024;
+    if (window <= 0.0 && !forced) {
+        gc.lastFrameMs = 0.0;
+        return;
+    }
+
+    const double start = nowMs();
+    if (gc.generational) {
+        // 세대별 모드의 한 스텝은 마이너 수집 한 번입니다.
+        lua_gc(L, LUA_GCSTEP, 0);
+        gc.lastCycleKB = (size_t)lua_gc(L, LUA_GCCOUNT);
+        gc.cycles++;
+    }
+    else {
+        while (true) {
+            if (lua_gc(L, LUA_GCSTEP, 0)) {
+                gc.lastCycleKB = (size_t)lua_gc(L, LUA_GCCOUNT);
+                gc.cycles++;
+                break;
+            }
+            if (!forced && nowMs() - start >= window) break;
+        }
+    }
+
+    gc.lastFrameMs = nowMs() - start;
+    if (gc.lastFrameMs > gc.budgetMs) gc.overBudgetFrames++;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+struct lua_State;
+
+// 프레임 남는 시간에 돌리는 GC (sys.gc). Lua C API만 사용합니다.
+// 수집기는 멈춰 두고 메인 루프가 Present 이후 남은 시간 안에서만 조금씩 진행시킵니다.
+struct GcSchedule {
+    bool enabled = false;      // false면 Lua 기본 자동 GC
+    bool generational = false;
+    double budgetMs = 2.0;     // 한 프레임에 GC에 쓸 최대 시간
+    size_t lastCycleKB = 0;    // 마지막 사이클 직후 힙 크기
+
+    double lastFrameMs = 0.0;  // 직전 프레임 GC 시간
+    uint64_t overBudgetFrames = 0;
+    uint64_t cycles = 0;
+};
+
+// "incremental" | "generational" | "auto"
+const char* GcModeName(const GcSchedule& gc);
+// 모르는 모드면 아무것도 바꾸지 않고 false
+bool SetGcMode(lua_State* L, GcSchedule& gc, std::string_view mode);
+
+// slackMs: 이번 프레임에 남은 시간. nowMs: 시간 측정용 시계 (ms, 테스트에서 바꿔 끼움)
+void RunScheduledGC(lua_State* L, GcSchedule& gc, double slackMs, double (*nowMs)());
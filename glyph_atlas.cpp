@@ -0,0 +1,207 @@
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+uint32_t DecodeUtf8(const char*& p, const char* end) {
+    const unsigned char c = (unsigned char)*p++;
+    if (c < 0x80) return c; // ASCII 빠른 경로
+
+    int extra;
+    uint32_t cp;
+    if ((c & 0xE0) == 0xC0) { extra = 1; cp = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { extra = 2; cp = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { extra = 3; cp = c & 0x07; }
+    else return 0xFFFD;
+
+    if (end - p < extra) { p = end; return 0xFFFD; }
+    for (int i = 0; i < extra; i++) {
+        const unsigned char cc = (unsigned char)p[i];
+        if ((cc & 0xC0) != 0x80) { p += i; return 0xFFFD; }
+        cp = (cp << 6) | (cc & 0x3F);
+    }
+    p += extra;
+    return cp;
+}
+
+GlyphAtlas::GlyphAtlas(int width, int height)
+    : width(width), height(height), pixels((size_t)width * height, 0) {
+    dirtyX0 = dirtyY0 = INT_MAX;
+    dirtyX1 = dirtyY1 = 0;
+}
+
+bool GlyphAtlas::Insert(int w, int h, const uint8_t* alpha, int& outX, int& outY) {
+    // 샘플링 번짐 방지용 1px 여백
+    const int pw = w + 1, ph = h + 1;
+    if (pw > width || ph > height) return false;
+
+    // 높이가 맞는 shelf 중 가장 낮은 것을 고릅니다.
+    Shelf* best = nullptr;
+    for (auto& s : shelves) {
+        if (s.height >= ph && s.x + pw <= width && (!best || s.height < best->height))
+            best = &s;
+    }
+    if (!best) {
+        if (nextShelfY + ph > height) return false;
+        shelves.push_back({ nextShelfY, ph, 0 });
+        nextShelfY += ph;
+        best = &shelves.back();
+    }
+
+    outX = best->x;
+    outY = best->y;
+    best->x += pw;
+
+    for (int row = 0; row < h; row++) {
+        memcpy(&pixels[(size_t)(outY + row) * width + outX], alpha + (size_t)row * w, w);
+    }
+
+    dirtyX0 = std::min(dirtyX0, outX);
+    dirtyY0 = std::min(dirtyY0, outY);
+    dirtyX1 = std::max(dirtyX1, outX + w);
+    dirtyY1 = std::max(dirtyY1, outY + h);
+    return true;
+}
+
+void GlyphAtlas::Reset() {
+    shelves.clear();
+    nextShelfY = 0;
+    generation++;
+    std::fill(pixels.begin(), pixels.end(), (uint8_t)0);
+    MarkAllDirty();
+}
+
+void GlyphAtlas::MarkAllDirty() {
+    dirtyX0 = dirtyY0 = 0;
+    dirtyX1 = width;
+    dirtyY1 = height;
+}
+
+bool GlyphAtlas::TakeDirty(int& x0, int& y0, int& x1, int& y1) {
+    if (dirtyX0 >= dirtyX1 || dirtyY0 >= dirtyY1) return false;
+
+    x0 = dirtyX0; y0 = dirtyY0; x1 = dirtyX1; y1 = dirtyY1;
+    dirtyX0 = dirtyY0 = INT_MAX;
+    dirtyX1 = dirtyY1 = 0;
+    return true;
+}
+
+GlyphFont::GlyphFont(GlyphAtlas* atlas, Rasterizer rasterizer, Kerning kerning, float lineHeight, float baseline)
+    : atlas(atlas), rasterizer(std::move(rasterizer)), kerning(std::move(kerning)),
+      lineHeight(lineHeight), baseline(baseline) {
+    if (atlas) atlasGeneration = atlas->Generation();
+}
+
+GlyphFont::GlyphFont(float lineHeight, float baseline)
+    : lineHeight(lineHeight), baseline(baseline) {}
+
+void GlyphFont::AddGlyph(uint32_t codepoint, const GlyphInfo& info) {
+    glyphs[codepoint] = info;
+}
+
+void GlyphFont::AddKerning(uint32_t left, uint32_t right, float amount) {
+    kerningCache[((uint64_t)left << 32) | right] = amount;
+}
+
+const GlyphInfo* GlyphFont::Find(uint32_t codepoint) {
+    if (atlas && atlasGeneration != atlas->Generation()) {
+        glyphs.clear();
+        atlasGeneration = atlas->Generation();
+    }
+
+    auto it = glyphs.find(codepoint);
+    if (it != glyphs.end()) return &it->second;
+    if (!rasterizer) return nullptr;
+
+    GlyphInfo info;
+    scratch.width = scratch.height = 0;
+    scratch.alpha.clear();
+
+    if (!rasterizer(codepoint, scratch)) {
+        info.missing = true;
+    }
+    else {
+        info.w = scratch.width;
+        info.h = scratch.height;
+        info.offsetX = scratch.offsetX;
+        info.offsetY = scratch.offsetY;
+        info.advance = scratch.advance;
+
+        if (info.w > 0 && info.h > 0 && atlas) {
+            if (!atlas->Insert(info.w, info.h, scratch.alpha.data(), info.x, info.y)) {
+                // 아틀라스가 가득 차면 통째로 비우고 다시 채웁니다.
+                atlas->Reset();
+                glyphs.clear();
+                atlasGeneration = atlas->Generation();
+                if (!atlas->Insert(info.w, info.h, scratch.alpha.data(), info.x, info.y))
+                    info.missing = true;
+            }
+        }
+    }
+    return &glyphs.emplace(codepoint, info).first->second;
+}
+
+float GlyphFont::KerningOf(uint32_t left, uint32_t right) {
+    const uint64_t key = ((uint64_t)left << 32) | right;
+    auto it = kerningCache.find(key);
+    if (it != kerningCache.end()) return it->second;
+    if (!kerning) return 0.0f;
+
+    float amount = kerning(left, right);
+    kerningCache.emplace(key, amount);
+    return amount;
+}
+
+bool GlyphFont::LayoutOnce(std::string_view text, float x, float y, std::vector<GlyphQuad>& out, float& width, float& height) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    float penX = x, penY = y;
+    float maxX = x;
+    uint32_t prev = 0;
+    int lines = text.empty() ? 0 : 1;
+
+    while (p < end) {
+        uint32_t cp = DecodeUtf8(p, end);
+        if (cp == '\r') continue;
+        if (cp == '\n') {
+            maxX = std::max(maxX, penX);
+            penX = x;
+            penY += lineHeight;
+            prev = 0;
+            lines++;
+            continue;
+        }
+
+        const GlyphInfo* gi = Find(cp);
+        if (!gi || gi->missing) {
+            // 온디맨드 폰트는 DrawText 폴백, BMFont는 그냥 건너뜁니다.
+            if (rasterizer) return false;
+            continue;
+        }
+
+        if (prev) penX += KerningOf(prev, cp);
+        if (gi->w > 0 && gi->h > 0) {
+            out.push_back({
+                penX + gi->offsetX, penY + baseline + gi->offsetY, (float)gi->w, (float)gi->h,
+                gi->x, gi->y, gi->w, gi->h, gi->page
+            });
+        }
+        penX += gi->advance;
+        prev = cp;
+    }
+
+    width = std::max(maxX, penX) - x;
+    height = lines * lineHeight;
+    return true;
+}
+
+bool GlyphFont::Layout(std::string_view text, float x, float y, std::vector<GlyphQuad>& out, float& width, float& height) {
+    // 레이아웃 도중 아틀라스가 리셋되면 앞쪽 쿼드가 무효가 되므로 한 번 더 돌립니다.
+    for (int attempt = 0; attempt < 2; attempt++) {
+        out.clear();
+        const uint32_t generation = atlas ? atlas->Generation() : 0;
+        if (!LayoutOnce(text, x, y, out, width, height)) return false;
+        if (!atlas || atlas->Generation() == generation) return true;
+    }
+    return false; // 한 문자열이 아틀라스보다 큼
+}
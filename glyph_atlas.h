@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 글리프 캐시 텍스트 렌더링용 아틀라스/레이아웃 (플랫폼 독립)
+// 래스터라이즈(DirectWrite)와 업로드(D2D)는 lua_res.cpp / lua_g.cpp 에서 담당합니다.
+
+// UTF-8 한 글자 디코딩. p를 다음 글자로 옮기고, 잘못된 바이트는 U+FFFD로 돌려줍니다.
+uint32_t DecodeUtf8(const char*& p, const char* end);
+
+// 래스터라이저 출력 (8비트 알파)
+struct GlyphBitmap {
+    int width = 0, height = 0;
+    float offsetX = 0.0f, offsetY = 0.0f; // 펜 위치(베이스라인) 기준 비트맵 좌상단
+    float advance = 0.0f;
+    std::vector<uint8_t> alpha;           // width * height
+};
+
+// 여러 폰트가 공유하는 8비트 알파 아틀라스 (shelf 패킹)
+class GlyphAtlas {
+public:
+    GlyphAtlas(int width, int height);
+
+    // 자리가 없으면 false. 호출 측에서 Reset 후 재시도합니다.
+    bool Insert(int w, int h, const uint8_t* alpha, int& outX, int& outY);
+    void Reset();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    const std::vector<uint8_t>& Pixels() const { return pixels; }
+
+    // Reset 될 때마다 증가. 폰트는 이 값이 바뀌면 자기 캐시를 버립니다.
+    uint32_t Generation() const { return generation; }
+
+    // GPU 업로드가 필요한 영역 [x0, x1) x [y0, y1)
+    bool TakeDirty(int& x0, int& y0, int& x1, int& y1);
+    void MarkAllDirty();
+
+private:
+    struct Shelf { int y, height, x; };
+
+    int width, height;
+    std::vector<uint8_t> pixels;
+    std::vector<Shelf> shelves;
+    int nextShelfY = 0;
+    uint32_t generation = 0;
+    int dirtyX0, dirtyY0, dirtyX1, dirtyY1;
+};
+
+struct GlyphInfo {
+    int x = 0, y = 0, w = 0, h = 0; // 원본 이미지 내 영역
+    float offsetX = 0.0f, offsetY = 0.0f;
+    float advance = 0.0f;
+    int page = -1;                  // -1: 공유 아틀라스, 그 외: g_bitmapTable 인덱스 (BMFont)
+    bool missing = false;
+};
+
+struct GlyphQuad {
+    float x, y, w, h;  // 화면 좌표
+    int sx, sy, sw, sh;
+    int page;
+};
+
+class GlyphFont {
+public:
+    using Rasterizer = std::function<bool(uint32_t codepoint, GlyphBitmap& out)>;
+    using Kerning = std::function<float(uint32_t left, uint32_t right)>;
+
+    // 온디맨드 래스터라이즈 폰트 (res.font / res.fontFile)
+    GlyphFont(GlyphAtlas* atlas, Rasterizer rasterizer, Kerning kerning, float lineHeight, float baseline);
+    // 미리 구워진 폰트 (res.bitmapFont)
+    GlyphFont(float lineHeight, float baseline);
+
+    void AddGlyph(uint32_t codepoint, const GlyphInfo& info);
+    void AddKerning(uint32_t left, uint32_t right, float amount);
+
+    // (x, y)는 g.text와 같이 첫 줄의 좌상단입니다.
+    // 없는 글리프가 있으면 false (호출 측에서 DrawText로 폴백)
+    bool Layout(std::string_view text, float x, float y, std::vector<GlyphQuad>& out, float& width, float& height);
+
+    float LineHeight() const { return lineHeight; }
+
+private:
+    const GlyphInfo* Find(uint32_t codepoint);
+    float KerningOf(uint32_t left, uint32_t right);
+    bool LayoutOnce(std::string_view text, float x, float y, std::vector<GlyphQuad>& out, float& width, float& height);
+
+    GlyphAtlas* atlas = nullptr;
+    Rasterizer rasterizer;
+    Kerning kerning;
+    float lineHeight, baseline;
+    uint32_t atlasGeneration = 0;
+    std::unordered_map<uint32_t, GlyphInfo> glyphs;
+    std::unordered_map<uint64_t, float> kerningCache;
+    GlyphBitmap scratch;
+};
@@ -0,0 +1,141 @@
+#include "hit_index.h"
+#include <algorithm>
+#include <cmath>
+
+HitIndex::HitIndex(float cellSize)
+    : cellSize(cellSize > 1.0f ? cellSize : 1.0f), invCellSize(1.0f / this->cellSize) {
+}
+
+int HitIndex::CellCoord(float v) const {
+    // 아주 큰 좌표나 NaN에서 int 변환이 넘치지 않도록 제한
+    const float c = floorf(v * invCellSize);
+    if (!(c > -1.0e9f)) return -1000000000;
+    if (c > 1.0e9f) return 1000000000;
+    return (int)c;
+}
+
+static void EraseSlot(std::vector<uint32_t>& list, uint32_t slot) {
+    auto it = std::find(list.begin(), list.end(), slot);
+    if (it == list.end()) return;
+    *it = list.back();
+    list.pop_back();
+}
+
+void HitIndex::Link(uint32_t slot) {
+    Region& r = regions[slot];
+    r.cx0 = CellCoord(r.x0);
+    r.cy0 = CellCoord(r.y0);
+    r.cx1 = CellCoord(r.x1);
+    r.cy1 = CellCoord(r.y1);
+
+    const int64_t cellCount = (int64_t)(r.cx1 - r.cx0 + 1) * (r.cy1 - r.cy0 + 1);
+    r.large = cellCount > kMaxCellsPerRegion;
+    if (r.large) {
+        largeRegions.push_back(slot);
+        return;
+    }
+    for (int cy = r.cy0; cy <= r.cy1; cy++) {
+        for (int cx = r.cx0; cx <= r.cx1; cx++) cells[CellKey(cx, cy)].push_back(slot);
+    }
+}
+
+void HitIndex::Unlink(uint32_t slot) {
+    const Region& r = regions[slot];
+    if (r.large) {
+        EraseSlot(largeRegions, slot);
+        return;
+    }
+    for (int cy = r.cy0; cy <= r.cy1; cy++) {
+        for (int cx = r.cx0; cx <= r.cx1; cx++) {
+            auto it = cells.find(CellKey(cx, cy));
+            if (it == cells.end()) continue;
+            EraseSlot(it->second, slot);
+            if (it->second.empty()) cells.erase(it);
+        }
+    }
+}
+
+void HitIndex::Set(int id, float x, float y, float w, float h, int z) {
+    // 음수 크기는 반대 방향으로 정규화
+    if (w < 0.0f) { x += w; w = -w; }
+    if (h < 0.0f) { y += h; h = -h; }
+
+    auto it = slotOf.find(id);
+    uint32_t slot;
+    if (it != slotOf.end()) {
+        slot = it->second;
+        Region& old = regions[slot];
+        // 같은 칸 범위 안에서 움직였으면 격자는 그대로 두고 좌표만 바꿉니다.
+        if (!old.large && CellCoord(x) == old.cx0 && CellCoord(y) == old.cy0 &&
+            CellCoord(x + w) == old.cx1 && CellCoord(y + h) == old.cy1) {
+            old.x0 = x; old.y0 = y; old.x1 = x + w; old.y1 = y + h;
+            old.z = z;
+            return;
+        }
+        Unlink(slot);
+    }
+    else {
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            slot = (uint32_t)regions.size();
+            regions.emplace_back();
+        }
+        slotOf[id] = slot;
+        regions[slot].order = nextOrder++;
+    }
+
+    Region& r = regions[slot];
+    r.x0 = x; r.y0 = y; r.x1 = x + w; r.y1 = y + h;
+    r.id = id;
+    r.z = z;
+    Link(slot);
+}
+
+bool HitIndex::Move(int id, float x, float y, float w, float h) {
+    auto it = slotOf.find(id);
+    if (it == slotOf.end()) return false;
+    Set(id, x, y, w, h, regions[it->second].z);
+    return true;
+}
+
+bool HitIndex::Remove(int id) {
+    auto it = slotOf.find(id);
+    if (it == slotOf.end()) return false;
+
+    Unlink(it->second);
+    freeSlots.push_back(it->second);
+    slotOf.erase(it);
+    return true;
+}
+
+void HitIndex::Clear() {
+    regions.clear();
+    freeSlots.clear();
+    slotOf.clear();
+    cells.clear();
+    largeRegions.clear();
+    nextOrder = 0;
+}
+
+bool HitIndex::Hit(float x, float y, int& outId) const {
+    const Region* best = nullptr;
+    auto test = [&](uint32_t slot) {
+        const Region& r = regions[slot];
+        // NaN 좌표는 어떤 사각형에도 들어가지 않도록 포함 조건으로 검사
+        if (!(x >= r.x0 && x < r.x1 && y >= r.y0 && y < r.y1)) return;
+        if (!best || IsAbove(r, *best)) best = &r;
+        };
+
+    auto it = cells.find(CellKey(CellCoord(x), CellCoord(y)));
+    if (it != cells.end()) {
+        for (uint32_t slot : it->second) test(slot);
+    }
+    for (uint32_t slot : largeRegions) test(slot);
+
+    if (!best) return false;
+    outId = best->id;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 마우스 히트 테스트용 사각형 인덱스 (플랫폼 독립, 균일 격자)
+// 위젯 id마다 사각형과 z를 등록해 두면 점 하나에 대해 가장 위에 있는 id를 찾습니다.
+// 칸을 너무 많이 덮는 큰 사각형(배경 패널 등)은 격자에 넣지 않고 따로 모아 매번 검사합니다.
+class HitIndex {
+public:
+    explicit HitIndex(float cellSize = 64.0f);
+
+    // id가 이미 있으면 위치/z만 바꿉니다. (같은 z끼리는 먼저 추가된 것이 아래)
+    void Set(int id, float x, float y, float w, float h, int z = 0);
+    // z는 그대로 두고 위치만 바꿉니다. id가 없으면 false
+    bool Move(int id, float x, float y, float w, float h);
+    bool Has(int id) const { return slotOf.count(id) != 0; }
+    bool Remove(int id);
+    void Clear();
+
+    // (x, y)를 덮는 가장 위 사각형의 id. 없으면 false
+    bool Hit(float x, float y, int& outId) const;
+    bool Interactive(float x, float y) const {
+        int id;
+        return Hit(x, y, id);
+    }
+    size_t Count() const { return slotOf.size(); }
+
+private:
+    static constexpr int kMaxCellsPerRegion = 64;
+
+    struct Region {
+        float x0, y0, x1, y1;
+        int id;
+        int z;
+        uint32_t order;  // 추가 순서 (같은 z에서 나중 것이 위)
+        int cx0, cy0, cx1, cy1;
+        bool large;      // 격자 대신 largeRegions에 들어 있음
+    };
+
+    float cellSize;
+    float invCellSize;
+    uint32_t nextOrder = 0;
+
+    std::vector<Region> regions;                 // 슬롯 (삭제된 자리는 freeSlots로 재사용)
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<int, uint32_t> slotOf;    // id -> 슬롯
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells; // 칸 -> 슬롯 목록
+    std::vector<uint32_t> largeRegions;
+
+    static uint64_t CellKey(int cx, int cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    }
+    int CellCoord(float v) const;
+    void Link(uint32_t slot);
+    void Unlink(uint32_t slot);
+    bool IsAbove(const Region& a, const Region& b) const {
+        return a.z != b.z ? a.z > b.z : a.order > b.order;
+    }
+};
@@ -0,0 +1,149 @@
+#include "lua_alloc.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+LuaPoolAllocator::~LuaPoolAllocator() {
+    // 상태가 이미 닫혀서 작은 블록은 모두 free-list에 돌아와 있으므로 슬랩만 놓으면 됩니다.
+    for (size_t i = 0; i < looseCount; i++) free(loose[i]);
+    while (slabs) {
+        FreeNode* next = slabs->next;
+        free(slabs);
+        slabs = next;
+    }
+}
+
+void* LuaPoolAllocator::AllocSmall(size_t cls) {
+    if (FreeNode* node = freeLists[cls]) {
+        freeLists[cls] = node->next;
+        return node;
+    }
+
+    const size_t size = (cls + 1) * kGranularity;
+    if (bumpCur + size > bumpEnd) {
+        if (stats.reservedBytes + kSlabSize > maxReservedBytes) return nullptr;
+        char* slab = (char*)malloc(kSlabSize);
+        if (!slab) return nullptr;
+
+        // 이전 슬랩의 자투리는 맞는 크기 클래스에 넘겨서 버리지 않습니다.
+        size_t rest = bumpEnd - bumpCur;
+        if (rest >= kGranularity) FreeSmall(bumpCur, ClassOf(rest));
+
+        ((FreeNode*)slab)->next = slabs;
+        slabs = (FreeNode*)slab;
+        bumpCur = slab + kGranularity; // 첫 칸은 슬랩 연결용
+        bumpEnd = slab + kSlabSize;
+        stats.reservedBytes += kSlabSize;
+    }
+
+    void* p = bumpCur;
+    bumpCur += size;
+    return p;
+}
+
+void LuaPoolAllocator::FreeSmall(void* p, size_t cls) {
+    FreeNode* node = (FreeNode*)p;
+    node->next = freeLists[cls];
+    freeLists[cls] = node;
+}
+
+bool LuaPoolAllocator::IsLoose(void* p) const {
+    for (size_t i = 0; i < looseCount; i++) {
+        if (loose[i] == p) return true;
+    }
+    return false;
+}
+
+void LuaPoolAllocator::DropLoose(void* p) {
+    for (size_t i = 0; i < looseCount; i++) {
+        if (loose[i] == p) {
+            loose[i] = loose[--looseCount];
+            return;
+        }
+    }
+}
+
+void* LuaPoolAllocator::Realloc(void* ptr, size_t osize, size_t nsize) {
+    const bool newSmall = nsize <= kMaxSmall;
+    if (!ptr) return newSmall ? AllocSmall(ClassOf(nsize)) : malloc(nsize);
+
+    const bool oldSmall = osize <= kMaxSmall && !(looseCount && IsLoose(ptr));
+    const size_t oldClass = osize ? ClassOf(osize) : 0;
+
+    if (oldSmall && newSmall) {
+        if (ClassOf(nsize) == oldClass) return ptr;
+        void* p = AllocSmall(ClassOf(nsize));
+        // Lua는 줄이는 재할당이 실패하지 않는다고 가정하므로 기존 블록을 그대로 씁니다.
+        if (!p) return nsize < osize ? ptr : nullptr;
+        memcpy(p, ptr, std::min(osize, nsize));
+        FreeSmall(ptr, oldClass);
+        return p;
+    }
+    if (!oldSmall && !newSmall) {
+        void* p = realloc(ptr, nsize);
+        if (!p) return nsize < osize ? ptr : nullptr;
+        if (osize <= kMaxSmall) DropLoose(ptr); // 따로 두었던 블록이 다시 커짐
+        return p;
+    }
+    if (oldSmall) {
+        void* p = malloc(nsize);
+        if (!p) return nullptr;
+        memcpy(p, ptr, osize);
+        FreeSmall(ptr, oldClass);
+        return p;
+    }
+
+    // 큰 블록 -> 작은 블록
+    void* p = AllocSmall(ClassOf(nsize));
+    if (!p) {
+        // 풀이 모자라면 malloc 블록을 그대로 쓰고, 해제할 때 free로 가도록 기억해 둡니다.
+        // 기억할 칸까지 다 찼으면 실패를 돌려줍니다. (그 정도로 모자라면 어차피 메모리 오류)
+        if (osize <= kMaxSmall) return ptr; // 이미 따로 둔 블록
+        if (looseCount == kMaxLoose) return nullptr;
+        loose[looseCount++] = ptr;
+        return ptr;
+    }
+    memcpy(p, ptr, nsize);
+    free(ptr);
+    if (osize <= kMaxSmall) DropLoose(ptr);
+    return p;
+}
+
+void* LuaPoolAllocator::Alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    auto* self = static_cast<LuaPoolAllocator*>(ud);
+    // ptr이 NULL이면 osize는 크기가 아니라 객체 종류입니다.
+    const size_t old = ptr ? osize : 0;
+
+    if (nsize == 0) {
+        if (ptr) {
+            if (old > kMaxSmall) free(ptr);
+            else if (self->looseCount && self->IsLoose(ptr)) {
+                self->DropLoose(ptr);
+                free(ptr);
+            }
+            else self->FreeSmall(ptr, old ? ClassOf(old) : 0);
+            self->stats.liveBytes -= old;
+        }
+        return nullptr;
+    }
+
+    void* p = self->Realloc(ptr, old, nsize);
+    if (!p) return nullptr;
+
+    auto& st = self->stats;
+    st.liveBytes = st.liveBytes - old + nsize;
+    st.peakBytes = std::max(st.peakBytes, st.liveBytes);
+    if (!ptr) {
+        st.totalAllocs++;
+        self->pendingAllocs++;
+    }
+    if (nsize > old) self->pendingBytes += nsize - old;
+    return p;
+}
+
+void LuaPoolAllocator::EndFrame() {
+    stats.frameAllocs = pendingAllocs;
+    stats.frameBytes = pendingBytes;
+    pendingAllocs = 0;
+    pendingBytes = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Lua 상태용 lua_Alloc (플랫폼 독립)
+// 256바이트 이하 블록은 16바이트 단위 크기 클래스별 free-list 풀에서,
+// 그보다 큰 블록은 realloc/free 로 처리합니다.
+// Lua는 해제/재할당 때 기존 블록 크기(osize)를 알려주므로 블록 헤더가 필요 없습니다.
+// 상태마다 하나씩 만들어 ud로 넘기고, 그 상태가 닫힌 뒤에 소멸시킵니다.
+struct LuaAllocStats {
+    size_t liveBytes = 0;       // 현재 Lua가 쥐고 있는 바이트
+    size_t peakBytes = 0;
+    size_t reservedBytes = 0;   // 풀 슬랩으로 잡아 둔 바이트
+    uint64_t totalAllocs = 0;
+    uint64_t frameAllocs = 0;   // 직전 프레임 할당 횟수
+    uint64_t frameBytes = 0;    // 직전 프레임 할당 바이트
+};
+
+class LuaPoolAllocator {
+public:
+    LuaPoolAllocator() = default;
+    ~LuaPoolAllocator();
+    LuaPoolAllocator(const LuaPoolAllocator&) = delete;
+    LuaPoolAllocator& operator=(const LuaPoolAllocator&) = delete;
+
+    // sol::state(panic, &LuaPoolAllocator::Alloc, allocator) 형태로 넘깁니다.
+    static void* Alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // 프레임 단위 통계를 넘깁니다. (매 프레임 Draw 이후 호출)
+    void EndFrame();
+    const LuaAllocStats& Stats() const { return stats; }
+
+    // 슬랩 예약 상한. 넘으면 작은 블록 할당이 실패합니다. (메모리 제한, 테스트의 OOM 주입용)
+    size_t maxReservedBytes = SIZE_MAX;
+
+private:
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kMaxSmall = 256;
+    static constexpr size_t kClassCount = kMaxSmall / kGranularity;
+    static constexpr size_t kSlabSize = 64 * 1024;
+    static constexpr size_t kMaxLoose = 64;
+
+    struct FreeNode { FreeNode* next; };
+
+    static size_t ClassOf(size_t size) { return (size - 1) / kGranularity; }
+
+    void* AllocSmall(size_t cls);
+    void FreeSmall(void* p, size_t cls);
+    void* Realloc(void* ptr, size_t osize, size_t nsize);
+
+    // 큰 블록을 작게 줄이는데 풀이 모자라서 malloc 블록을 그대로 돌려준 경우.
+    // 크기만 보면 작은 블록이라 FreeSmall로 가면 안 되므로 따로 기억해 둡니다. (거의 항상 비어 있음)
+    bool IsLoose(void* p) const;
+    void DropLoose(void* p);
+
+    FreeNode* freeLists[kClassCount] = {};
+    FreeNode* slabs = nullptr;   // 슬랩 첫 16바이트에 다음 슬랩 포인터
+    char* bumpCur = nullptr;
+    char* bumpEnd = nullptr;
+    void* loose[kMaxLoose] = {};
+    size_t looseCount = 0;
+
+    LuaAllocStats stats;
+    uint64_t pendingAllocs = 0;
+    uint64_t pendingBytes = 0;
+};
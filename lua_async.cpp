@@ -0,0 +1,73 @@
+#include "lua_engine.h"
+
+// 코루틴 기반 비동기 스케줄러 바인딩 (본체는 async_sched.cpp)
+// sys.async(fn)로 시작한 코루틴만 task:await(), sys.sleep(ms), sys.nextFrame()으로 양보할 수 있습니다.
+// 태스크를 기다리는 코루틴은 태스크의 침입형 리스트에 걸어 두고,
+// 워커 스레드가 NotifyTaskReady를 부를 때만 깨웁니다. (대기 중인 태스크는 매 프레임 확인하지 않음)
+
+static AsyncScheduler g_async;
+
+bool ITask::Ready(lua_State* L) {
+    return isDone || check(sol::this_state{ L });
+}
+
+void ITask::PushResult(lua_State* L) {
+    sol::stack::push(L, getResult());
+}
+
+void NotifyTaskReady(std::weak_ptr<ITask> task) {
+    g_async.Notify(std::move(task));
+}
+
+size_t AsyncCoroutineCount() {
+    return g_async.Count();
+}
+
+size_t AsyncAwaitingCount() {
+    return g_async.AwaitingCount();
+}
+
+// task:await() -> 결과
+int ITask_await(lua_State* L) {
+    // task.await()처럼 점으로 부르면 1번 인자가 Task가 아님 (확인 없이 꺼내면 잘못된 메모리를 읽음)
+    if (!sol::stack::check<ITask>(L, 1, sol::no_panic))
+        return luaL_argerror(L, 1, "Task expected (call it as task:await())");
+    ITask& task = sol::stack::get<ITask&>(L, 1);
+    return g_async.Await(L, task);
+}
+
+// sys.async(fn, ...) -> 코루틴 (sys.cancel에 넘길 수 있음, coroutine.resume으로 직접 재개하지 않음)
+static int l_async(lua_State* L) {
+    return g_async.Spawn(L);
+}
+
+// sys.cancel(co) -> 살아 있던 코루틴이면 true
+static int l_cancel(lua_State* L) {
+    return g_async.Cancel(L, 1);
+}
+
+// sys.nextFrame()
+static int l_next_frame(lua_State* L) {
+    return g_async.NextFrame(L);
+}
+
+// sys.sleep(ms)
+static int l_sleep(lua_State* L) {
+    return g_async.Sleep(L, luaL_checknumber(L, 1));
+}
+
+void TickAsyncScheduler(double dtms) {
+    g_async.Tick(dtms);
+}
+
+void ResetAsyncScheduler() {
+    // 상태를 닫기 전에 호출해야 코루틴 참조를 안전하게 풀 수 있습니다.
+    g_async.Reset();
+}
+
+void register_async(sol::table& sys) {
+    sys["async"] = &l_async;
+    sys["cancel"] = &l_cancel;
+    sys["sleep"] = &l_sleep;
+    sys["nextFrame"] = &l_next_frame;
+}
@@ -0,0 +1,302 @@
+#include "lua_cache.h"
+#include <lua.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 컴파일된 청크 캐시
+// 메모리 캐시는 F5 리로드(sol::state 재생성) 사이에 유지되고,
+// 디스크 캐시(.luacache/)는 다음 실행의 콜드 스타트에 쓰입니다.
+
+bool g_useChunkCache = true;
+ChunkCacheStats g_chunkCacheStats;
+
+static double SteadyNowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static double (*g_nowMs)() = SteadyNowMs;
+
+void SetChunkCacheClock(double (*nowMs)()) {
+    g_nowMs = nowMs ? nowMs : SteadyNowMs;
+}
+
+static const char* kCacheDir = ".luacache";
+
+struct SourceFile {
+    bool ok = false;
+    std::string text;
+    uint64_t hash = 0;
+    int64_t mtime = 0;   // 읽기 직전의 수정 시각/크기. 프리페치한 뒤 파일이 바뀌었는지 비교용
+    uintmax_t size = 0;
+};
+
+struct ChunkEntry {
+    uint64_t hash = 0;
+    std::string bytecode;
+};
+
+static std::unordered_map<std::string, ChunkEntry> g_chunkCache;      // 경로 -> 바이트코드
+static std::unordered_map<std::string, std::shared_future<SourceFile>> g_prefetched;
+static std::vector<std::future<void>> g_prefetchWorkers;
+static std::set<std::string> g_manifest;                               // 디스크 캐시에 기록된 경로
+static bool g_manifestLoaded = false;
+
+static uint64_t HashBytes(const char* data, size_t size, uint64_t h = 14695981039346656037ull) {
+    for (size_t i = 0; i < size; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static bool ReadWholeFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, std::ios::end);
+    out.resize((size_t)file.tellg());
+    file.seekg(0, std::ios::beg);
+    file.read(out.data(), (std::streamsize)out.size());
+    return true;
+}
+
+static bool StatSource(const std::string& path, int64_t& mtime, uintmax_t& size) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    mtime = (int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+static SourceFile ReadSource(const std::string& path) {
+    SourceFile src;
+    // 읽는 도중 바뀌면 다음 비교에서 걸리도록 스탬프를 먼저 찍습니다.
+    if (!StatSource(path, src.mtime, src.size)) return src;
+    src.ok = ReadWholeFile(path, src.text);
+    if (src.ok) src.hash = HashBytes(src.text.data(), src.text.size());
+    return src;
+}
+
+static std::string DiskCachePath(const std::string& path) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.luac", (unsigned long long)HashBytes(path.data(), path.size()));
+    return std::string(kCacheDir) + "/" + name;
+}
+
+static std::string ManifestPath() {
+    return std::string(kCacheDir) + "/manifest.txt";
+}
+
+static void LoadManifest() {
+    if (g_manifestLoaded) return;
+    g_manifestLoaded = true;
+
+    std::ifstream file(ManifestPath());
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) g_manifest.insert(line);
+    }
+}
+
+// 소스가 없어진 경로는 매니페스트, 메모리 캐시, .luac 파일에서 모두 지웁니다.
+static void PruneMissingSources() {
+    std::error_code ec;
+    std::vector<std::string> gone;
+    for (const auto& path : g_manifest) {
+        if (!std::filesystem::exists(path, ec) && !ec) gone.push_back(path);
+    }
+    if (gone.empty()) return;
+
+    for (const auto& path : gone) {
+        g_manifest.erase(path);
+        g_chunkCache.erase(path);
+        std::filesystem::remove(DiskCachePath(path), ec);
+    }
+    std::ofstream manifest(ManifestPath(), std::ios::trunc);
+    for (const auto& path : g_manifest) manifest << path << "\n";
+}
+
+// 디스크 캐시 파일 형식: [내용 해시 8바이트][바이트코드]
+static bool LoadDiskEntry(const std::string& path, uint64_t hash, ChunkEntry& out) {
+    std::string data;
+    if (!ReadWholeFile(DiskCachePath(path), data) || data.size() <= sizeof(uint64_t)) return false;
+
+    uint64_t stored;
+    memcpy(&stored, data.data(), sizeof(stored));
+    if (stored != hash) return false;
+
+    out.hash = hash;
+    out.bytecode = data.substr(sizeof(uint64_t));
+    return true;
+}
+
+static void SaveDiskEntry(const std::string& path, const ChunkEntry& entry) {
+    std::error_code ec;
+    std::filesystem::create_directories(kCacheDir, ec);
+
+    std::ofstream file(DiskCachePath(path), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return;
+    file.write((const char*)&entry.hash, sizeof(entry.hash));
+    file.write(entry.bytecode.data(), (std::streamsize)entry.bytecode.size());
+
+    if (g_manifest.insert(path).second) {
+        std::ofstream manifest(ManifestPath(), std::ios::app);
+        manifest << path << "\n";
+    }
+}
+
+static int DumpWriter(lua_State*, const void* p, size_t sz, void* ud) {
+    static_cast<std::string*>(ud)->append((const char*)p, sz);
+    return 0;
+}
+
+void WaitForPrefetch() {
+    for (auto& worker : g_prefetchWorkers) worker.wait();
+}
+
+void PrefetchLuaSources(const std::string& entry) {
+    // 이전 프리페치가 남아 있으면 끝날 때까지 기다렸다가 버립니다.
+    g_prefetchWorkers.clear();
+    g_prefetched.clear();
+    g_chunkCacheStats = ChunkCacheStats();
+    if (!g_useChunkCache) return;
+
+    LoadManifest();
+    PruneMissingSources();
+    std::set<std::string> paths(g_manifest);
+    for (const auto& [path, chunk] : g_chunkCache) paths.insert(path);
+    paths.insert(entry);
+
+    // 경로마다 promise를 걸어 두고 워커 몇 개가 나눠서 읽고 해시합니다.
+    auto promises = std::make_shared<std::vector<std::pair<std::string, std::promise<SourceFile>>>>();
+    promises->reserve(paths.size());
+    for (const auto& path : paths) {
+        promises->emplace_back(path, std::promise<SourceFile>());
+        g_prefetched[path] = promises->back().second.get_future().share();
+    }
+
+    const size_t workerCount = (std::max)(1u, (std::min)(std::thread::hardware_concurrency(), 8u));
+    for (size_t w = 0; w < workerCount; w++) {
+        g_prefetchWorkers.push_back(std::async(std::launch::async, [promises, w, workerCount]() {
+            for (size_t i = w; i < promises->size(); i += workerCount) {
+                auto& [path, promise] = (*promises)[i];
+                promise.set_value(ReadSource(path));
+            }
+            }));
+    }
+}
+
+int LoadLuaChunk(lua_State* L, const std::string& path) {
+    const std::string chunkName = "@" + path;
+
+    // 1. 소스 읽기 (프리페치된 것이 있으면 그것을 기다림)
+    double t0 = g_nowMs();
+    SourceFile src;
+    auto pre = g_prefetched.find(path);
+    if (pre != g_prefetched.end()) {
+        src = pre->second.get();
+        g_prefetched.erase(pre);
+
+        // 프리페치 이후에 파일이 수정됐으면 버리고 다시 읽음
+        int64_t mtime;
+        uintmax_t size;
+        if (!StatSource(path, mtime, size) || !src.ok || mtime != src.mtime || size != src.size)
+            src = ReadSource(path);
+    }
+    else {
+        src = ReadSource(path);
+    }
+    g_chunkCacheStats.readMs += g_nowMs() - t0;
+
+    if (!src.ok) {
+        lua_pushfstring(L, "cannot open %s", path.c_str());
+        return LUA_ERRFILE;
+    }
+    if (!g_useChunkCache) {
+        return luaL_loadbufferx(L, src.text.data(), src.text.size(), chunkName.c_str(), "t");
+    }
+
+    // 2. 메모리 캐시 -> 디스크 캐시 순서로 찾기
+    auto it = g_chunkCache.find(path);
+    if (it == g_chunkCache.end() || it->second.hash != src.hash) {
+        ChunkEntry disk;
+        if (LoadDiskEntry(path, src.hash, disk))
+            it = g_chunkCache.insert_or_assign(path, std::move(disk)).first;
+    }
+    if (it != g_chunkCache.end() && it->second.hash == src.hash) {
+        const auto& bc = it->second.bytecode;
+        if (luaL_loadbufferx(L, bc.data(), bc.size(), chunkName.c_str(), "b") == LUA_OK) {
+            g_chunkCacheStats.hits++;
+            return LUA_OK;
+        }
+        lua_pop(L, 1); // Lua 버전이 바뀌었거나 파일이 깨짐 -> 다시 컴파일
+    }
+
+    // 3. 소스 컴파일 후 캐시에 저장 (디버그 정보는 남겨서 에러 줄 번호 유지)
+    t0 = g_nowMs();
+    int status = luaL_loadbufferx(L, src.text.data(), src.text.size(), chunkName.c_str(), "t");
+    g_chunkCacheStats.compileMs += g_nowMs() - t0;
+    if (status != LUA_OK) return status;
+
+    ChunkEntry entry;
+    entry.hash = src.hash;
+    lua_dump(L, DumpWriter, &entry.bytecode, 0);
+    SaveDiskEntry(path, entry);
+    g_chunkCache.insert_or_assign(path, std::move(entry));
+    g_chunkCacheStats.misses++;
+    return LUA_OK;
+}
+
+// package.searchers[2]: package.path로 파일을 찾고 LoadLuaChunk로 로드
+static int ChunkSearcher(lua_State* L) {
+    const char* name = luaL_checkstring(L, 1);
+
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "searchpath");
+    lua_pushstring(L, name);
+    lua_getfield(L, -3, "path");
+    lua_call(L, 2, 2);
+    if (lua_isnil(L, -2)) return 0; // 기본 파일 searcher가 에러 메시지를 만듭니다.
+
+    int status;
+    {
+        // lua_error는 longjmp 하므로 std::string은 이 블록 안에서 정리합니다.
+        std::string path = lua_tostring(L, -2);
+        status = LoadLuaChunk(L, path);
+        if (status != LUA_OK) {
+            lua_pushfstring(L, "error loading module '%s' from file '%s':\n\t%s",
+                name, path.c_str(), lua_tostring(L, -1));
+        }
+        else {
+            lua_pushstring(L, path.c_str());
+        }
+    }
+    if (status != LUA_OK) return lua_error(L);
+    return 2;
+}
+
+void InstallChunkSearcher(lua_State* L) {
+    if (!g_useChunkCache) return;
+
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "searchers");
+    // preload searcher(1번) 다음에 끼워 넣고 나머지는 한 칸씩 밀기
+    for (lua_Integer i = (lua_Integer)luaL_len(L, -1); i >= 2; i--) {
+        lua_rawgeti(L, -1, i);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_pushcfunction(L, ChunkSearcher);
+    lua_rawseti(L, -2, 2);
+    lua_pop(L, 2);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+
+struct lua_State;
+
+// 컴파일된 청크 캐시 (Lua C API만 사용, sol/Win32 의존성 없음)
+// 소스 경로 + 내용 해시가 같으면 lua_dump 해 둔 바이트코드를 바로 로드합니다.
+// 디스크 캐시는 현재 작업 디렉터리의 .luacache/ 에 둡니다.
+struct ChunkCacheStats {
+    int hits = 0, misses = 0;
+    double readMs = 0.0;     // 소스 대기/읽기 시간
+    double compileMs = 0.0;  // 캐시 미스로 컴파일한 시간
+};
+extern bool g_useChunkCache;
+extern ChunkCacheStats g_chunkCacheStats;
+
+// 읽기/컴파일 시간 측정용 시계 (ms). 기본은 steady_clock, 엔진은 GetTimeMs를 넣습니다.
+void SetChunkCacheClock(double (*nowMs)());
+
+// 통계를 비우고, 소스가 사라진 캐시를 정리한 뒤 알려진 소스를 워커 스레드에서 미리 읽습니다.
+void PrefetchLuaSources(const std::string& entry);
+void WaitForPrefetch(); // 프리페치 워커가 모두 끝날 때까지 대기
+int LoadLuaChunk(lua_State* L, const std::string& path);
+// package.searchers[2]를 캐시를 거치는 파일 searcher로 바꿉니다. (원래 것들은 한 칸씩 뒤로)
+void InstallChunkSearcher(lua_State* L);
@@ -12,12 +12,22 @@
 #include <fstream>
 #include <gdiplus.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <d2d1.h>
 #include <dwrite.h>
 #include <wincodec.h> // 이미지 로딩을 위한 WIC
 
+#include "async_sched.h"
+#include "canvas.h"
+#include "gc_schedule.h"
+#include "glyph_atlas.h"
+#include "lua_cache.h"
+#include "lua_alloc.h"
+#include "sprite_anim.h"
+#include "watchdog.h"
+
 #pragma comment(lib, "d2d1.lib")
 #pragma comment(lib, "dwrite.lib")
 #pragma comment(lib, "Gdiplus.lib")
@@ -30,53 +40,152 @@ extern ID2D1DCRenderTarget* g_pDCRT;
 extern IDWriteFactory* g_pDWriteFactory;
 extern IWICImagingFactory* g_pWICFactory;
 
+// 현재 그리기 대상 (평소에는 g_pDCRT, g.setCanvas 중에는 캔버스)
+extern ID2D1RenderTarget* g_pRT;
+
 extern HWND g_hwnd;
 extern sol::state lua;
 
+// 상태의 ud에 붙어 있는 풀 할당기 (풀로 만든 상태가 아니면 nullptr)
+inline LuaPoolAllocator* PoolAllocatorOf(lua_State* L) {
+    void* ud = nullptr;
+    return lua_getallocf(L, &ud) == &LuaPoolAllocator::Alloc ? static_cast<LuaPoolAllocator*>(ud) : nullptr;
+}
+
 extern int gDrawW, gDrawH;
 extern std::vector<ID2D1Bitmap*> g_bitmapTable;
 extern std::vector<IDWriteTextFormat*> g_fontTable;
 extern std::map<std::string, int> g_pathCache;
 
+// 글리프 캐시 텍스트 (g_fontTable과 같은 인덱스, 캐시를 못 만든 폰트는 nullptr)
+extern GlyphAtlas g_glyphAtlas;
+extern ID2D1Bitmap* g_pGlyphAtlasBitmap;
+extern std::vector<std::unique_ptr<GlyphFont>> g_glyphFontTable;
+
+// 스프라이트 시트 (res.spritesheet)와 애니메이션 상태 풀 (g.newAnim, 매 프레임 Update 전에 진행)
+extern std::vector<std::unique_ptr<SpriteSheet>> g_spriteSheets;
+extern AnimPool g_animPool;
+
+// g.newAnim이 돌려주는 핸들. 유저데이터가 정리될 때 풀 슬롯을 반환합니다.
+struct Anim {
+    AnimHandle handle;
+    int sheetId = -1;
+
+    Anim() = default;
+    Anim(const Anim&) = delete;
+    Anim& operator=(const Anim&) = delete;
+    ~Anim() { g_animPool.Destroy(handle); }
+};
+
 struct StateLayer {
     D2D1_MATRIX_3X2_F matrix;
     int clipDepth; // 해당 push 시점의 클립 깊이
 };
 
-struct ITask {
-    virtual ~ITask() = default;
+// g.clip 영역. 실제로 무언가 그려질 때에만 렌더 타겟에 push 합니다.
+struct ClipEntry {
+    D2D1_RECT_F rect;         // g.clip에 넘긴 로컬 사각형
+    D2D1_MATRIX_3X2_F matrix; // g.clip 시점의 변환
+    D2D1_RECT_F cull;         // 화면 좌표 컬링 영역 (뷰포트, 상위 클립과의 교집합)
+};
+
+// 변환/클립 상태를 CPU에서 들고 있다가 그리기 직전에만 렌더 타겟에 반영합니다.
+// 그리기 대상마다 하나이며, g.setCanvas 중에는 메인 타겟의 상태를 따로 보관합니다.
+struct DrawState {
+    D2D1_MATRIX_3X2_F matrix = D2D1::Matrix3x2F::Identity();
+    D2D1_MATRIX_3X2_F rtMatrix = D2D1::Matrix3x2F::Identity(); // 렌더 타겟에 마지막으로 넣은 행렬
+    std::vector<StateLayer> stack;
+    std::vector<ClipEntry> clips;
+    int appliedClips = 0; // clips 앞쪽에서 실제로 push 된 개수
+};
+
+// g.stats()
+struct DrawStats {
+    uint64_t drawn = 0;
+    uint64_t culled = 0;      // 화면/클립 밖이라 D2D에 넘기지 않은 그리기
+    uint64_t transforms = 0;  // SetTransform 호출 수
+    uint64_t clips = 0;       // PushAxisAlignedClip 호출 수
+};
+
+// 비동기 리소스 태스크. 작업이 끝나면 워커 스레드에서 NotifyTaskReady를 불러야
+// task:await()로 기다리는 코루틴이 깨어납니다.
+struct ITask : AsyncWaitable {
     virtual bool check(sol::this_state s) = 0;
     virtual sol::object getResult() = 0;
     bool isDone = false;
+
+    bool Ready(lua_State* L) override;      // lua_async.cpp
+    void PushResult(lua_State* L) override;
 };
 
-extern int g_clipCount;
-extern std::vector<StateLayer> g_stateStack;
+// 코루틴 스케줄러 (lua_async.cpp)
+void NotifyTaskReady(std::weak_ptr<ITask> task);
+void TickAsyncScheduler(double dtms);
+void ResetAsyncScheduler();
+size_t AsyncCoroutineCount();
+size_t AsyncAwaitingCount(); // task:await 중인 코루틴 수
+int ITask_await(lua_State* L);
+void register_async(sol::table& sys);
+
+extern DrawState g_draw;
+void BeginFrameDraw();
+void EndFrameDraw();
+
+// 오프스크린 캔버스 (g.newCanvas). 렌더 타깃은 D2D 호환 타깃이고 비트맵은 g_bitmapTable[imageId]에 둡니다.
+// 디바이스 재생성 때는 g_canvases.DeviceLost()로 타깃을 버리고 다음 setCanvas 때 다시 만듭니다.
+extern CanvasSet g_canvases;
 
 // Lua가 들고 다닐 가벼운 객체
 struct JsonNode {
     nlohmann::json* node = nullptr;
 };
-inline std::wstring to_wstring(const std::string& s) {
+inline std::wstring to_wstring(std::string_view s) {
     if (s.empty()) return L"";
 
-    // 필요한 크기 계산
-    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, NULL, 0);
+    // 필요한 크기 계산 (길이를 직접 넘기므로 널 문자는 포함되지 않습니다)
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), NULL, 0);
     if (len <= 0) return L"";
 
     // wstring 공간 확보
     std::wstring buf(len, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, &buf[0], len);
-
-    // MultiByteToWideChar는 널 문자를 포함하므로, 끝의 \0를 제거해주는 게 좋습니다.
-    if (!buf.empty() && buf.back() == L'\0') {
-        buf.pop_back();
-    }
+    MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), &buf[0], len);
 
     return buf;
 }
 
 
+// 고해상도 타이머 (ms). 프레임/GC 시간 측정용
+inline double GetTimeMs() {
+    static const double msPerTick = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return 1000.0 / (double)f.QuadPart;
+    }();
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * msPerTick;
+}
+
+// 프레임 남는 시간에 돌리는 GC (sys.gc, gc_schedule.h). 메인 루프가 RunScheduledGC를 부릅니다.
+extern GcSchedule g_gcSchedule;
+
+// 트윈 (lua_tween.cpp, sys.tween). 매 프레임 Update 전에 진행하고 타깃에 한 번에 씁니다.
+void TickTweens(double dtms);
+void ResetTweens();
+void register_tween(sol::state& lua, sol::table& sys);
+
+// 프레임 히치 감시 (sys.watchdog). CALL_LUA_FUNC 구간마다 HitchPhase로 표시합니다.
+extern HitchWatchdog g_watchdog;
+
+// 마우스 히트 인덱스 (lua_input.cpp, is.setHitIndex)
+sol::object MouseHitId(int x, int y); // 맨 위 위젯 id, 없으면 nil
+void UpdateClickThrough();
+void ResetHitIndex();
+
+// 격자 길찾기 (lua_nav.cpp, res.navGrid)
+void register_nav(sol::state& lua, sol::table& res);
+void StopNavWorkers();
+
 template <class T>
 inline void SafeRelease(T** ppT) {
     if (ppT && *ppT) {
@@ -89,4 +198,5 @@ void register_draw(sol::state& lua, const char* name);
 void register_input(sol::state& lua, const char* name);
 void register_sys(sol::state& lua, const char* name);
 void register_res(sol::state& lua, const char* name);
-void RebuildAllBitmaps();
\ No newline at end of file
+void RebuildAllBitmaps();
+int LoadImageCached(const std::string& path);
\ No newline at end of file
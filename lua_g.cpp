@@ -1,21 +1,519 @@
 ﻿#include "lua_engine.h"
+#include "particles.h"
+#include <algorithm>
+#include <cstring>
 
 ID2D1SolidColorBrush* g_pSolidBrush = nullptr; // 전역 브러시 하나를 색상 변경 시마다 업데이트
 D2D1_COLOR_F g_d2dColor = { 1.0f, 1.0f, 1.0f, 1.0f }; // 현재 색상 저장용
-int g_clipCount = 0;
-std::vector<StateLayer> g_stateStack;
+DrawState g_draw;
+ID2D1Bitmap* g_pGlyphAtlasBitmap = nullptr;
+ID2D1RenderTarget* g_pRT = nullptr;
+// 캔버스에 그리는 동안 메인 타겟의 변환/클립 상태를 보관
+static CanvasStateSwap<DrawState> g_mainDraw;
+static DrawStats g_drawStats, g_lastDrawStats;
+
+// 변환된 사각형의 화면 좌표 AABB (중심 + 반크기로 계산해서 뒤집힌 사각형도 처리)
+static D2D1_RECT_F TransformBounds(const D2D1_MATRIX_3X2_F& m, const D2D1_RECT_F& r) {
+    const float cx = (r.left + r.right) * 0.5f, cy = (r.top + r.bottom) * 0.5f;
+    const float hx = fabsf(r.right - r.left) * 0.5f, hy = fabsf(r.bottom - r.top) * 0.5f;
+    const float tx = m._11 * cx + m._21 * cy + m._31;
+    const float ty = m._12 * cx + m._22 * cy + m._32;
+    const float ex = fabsf(m._11) * hx + fabsf(m._21) * hy;
+    const float ey = fabsf(m._12) * hx + fabsf(m._22) * hy;
+    return D2D1::RectF(tx - ex, ty - ey, tx + ex, ty + ey);
+}
+
+static D2D1_RECT_F ViewportRect() {
+    if (const Canvas* c = g_canvases.Active())
+        return D2D1::RectF(0.0f, 0.0f, (float)c->width, (float)c->height);
+    return D2D1::RectF(0.0f, 0.0f, (float)gDrawW, (float)gDrawH);
+}
+
+static D2D1_RECT_F CullRect() {
+    return g_draw.clips.empty() ? ViewportRect() : g_draw.clips.back().cull;
+}
+
+static void SetTargetTransform(const D2D1_MATRIX_3X2_F& m) {
+    if (memcmp(&m, &g_draw.rtMatrix, sizeof(m)) == 0) return;
+    g_pRT->SetTransform(m);
+    g_draw.rtMatrix = m;
+    g_drawStats.transforms++;
+}
+
+// 아직 push 하지 않은 클립을 g.clip 당시의 행렬로 순서대로 push
+static void ApplyPendingClips() {
+    auto& clips = g_draw.clips;
+    while (g_draw.appliedClips < (int)clips.size()) {
+        const ClipEntry& c = clips[g_draw.appliedClips++];
+        SetTargetTransform(c.matrix);
+        g_pRT->PushAxisAlignedClip(c.rect, D2D1_ANTIALIAS_MODE_ALIASED);
+        g_drawStats.clips++;
+    }
+}
+
+// 실제로 push 된 클립만 렌더 타겟에서 pop 합니다.
+static void PopClipsTo(size_t depth) {
+    while (g_draw.clips.size() > depth) {
+        if ((int)g_draw.clips.size() == g_draw.appliedClips) {
+            g_pRT->PopAxisAlignedClip();
+            g_draw.appliedClips--;
+        }
+        g_draw.clips.pop_back();
+    }
+}
+
+// local을 m으로 변환한 영역이 컬링 영역 밖이면 false.
+// 그릴 것이면 밀려 있던 클립과 행렬을 렌더 타겟에 반영합니다.
+static bool PrepareDraw(const D2D1_RECT_F& local, const D2D1_MATRIX_3X2_F& m) {
+    const D2D1_RECT_F cull = CullRect();
+    const D2D1_RECT_F b = TransformBounds(m, local);
+    if (cull.left >= cull.right || cull.top >= cull.bottom ||
+        b.right <= cull.left || b.left >= cull.right || b.bottom <= cull.top || b.top >= cull.bottom) {
+        g_drawStats.culled++;
+        return false;
+    }
+    ApplyPendingClips();
+    SetTargetTransform(m);
+    g_drawStats.drawn++;
+    return true;
+}
+
+static bool PrepareDraw(const D2D1_RECT_F& local) {
+    return PrepareDraw(local, g_draw.matrix);
+}
+
+void BeginFrameDraw() {
+    g_draw = DrawState();
+    g_pRT->SetTransform(g_draw.rtMatrix);
+}
+
+void EndFrameDraw() {
+    g_canvases.End(); // setCanvas()를 빼먹은 경우
+    PopClipsTo(0);     // EndDraw 전에 pop 안 된 클립 해제
+    g_draw.stack.clear();
+
+    g_lastDrawStats = g_drawStats;
+    g_drawStats = DrawStats();
+}
+
+// 캔버스 렌더 타깃. 호환 렌더 타겟은 DCRT와 리소스(브러시, 비트맵)를 공유합니다.
+struct D2DCanvasSurface : CanvasSurface {
+    ID2D1BitmapRenderTarget* target = nullptr;
+    int imageId = -1;
+
+    ~D2DCanvasSurface() override {
+        if (imageId >= 0 && imageId < (int)g_bitmapTable.size())
+            SafeRelease(&g_bitmapTable[imageId]);
+        SafeRelease(&target);
+    }
+    void Begin() override {
+        target->BeginDraw();
+        target->SetTransform(D2D1::Matrix3x2F::Identity());
+    }
+    bool End() override { return target->EndDraw() != D2DERR_RECREATE_TARGET; }
+    size_t Bytes() const override {
+        // 캔버스 크기는 DIP라 DPI에 따라 실제 픽셀 수와 다르므로 픽셀 크기로 셉니다.
+        auto size = target->GetPixelSize();
+        return (size_t)size.width * size.height * 4;
+    }
+};
+
+class D2DCanvasBackend : public CanvasBackend {
+public:
+    std::unique_ptr<CanvasSurface> CreateSurface(const Canvas& c) override {
+        if (!g_pDCRT || c.imageId < 0 || c.imageId >= (int)g_bitmapTable.size()) return nullptr;
+
+        auto surface = std::make_unique<D2DCanvasSurface>();
+        HRESULT hr = g_pDCRT->CreateCompatibleRenderTarget(
+            D2D1::SizeF((float)c.width, (float)c.height), &surface->target);
+        if (FAILED(hr)) {
+            printf("[Draw Error] Failed to create canvas %dx%d (HRESULT: 0x%08X)\n", c.width, c.height, hr);
+            return nullptr;
+        }
+
+        ID2D1Bitmap* bmp = nullptr;
+        surface->target->GetBitmap(&bmp);
+        SafeRelease(&g_bitmapTable[c.imageId]);
+        g_bitmapTable[c.imageId] = bmp;
+        surface->imageId = c.imageId;
+        return surface;
+    }
+};
+static D2DCanvasBackend g_canvasBackend;
+CanvasSet g_canvases(g_canvasBackend);
+
+static std::vector<GlyphQuad> g_glyphQuads; // 레이아웃 결과 재사용 버퍼
+
+// 아틀라스에서 바뀐 영역만 GPU 비트맵으로 올립니다. (흰색 * 알파, premultiplied)
+static bool SyncGlyphAtlas() {
+    if (!g_pGlyphAtlasBitmap) {
+        D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+        D2D1_SIZE_U size = D2D1::SizeU(g_glyphAtlas.Width(), g_glyphAtlas.Height());
+        if (FAILED(g_pRT->CreateBitmap(size, nullptr, 0, props, &g_pGlyphAtlasBitmap)))
+            return false;
+        g_glyphAtlas.MarkAllDirty();
+    }
+
+    int x0, y0, x1, y1;
+    if (g_glyphAtlas.TakeDirty(x0, y0, x1, y1)) {
+        static std::vector<UINT32> staging;
+        const int w = x1 - x0, h = y1 - y0;
+        const auto& pixels = g_glyphAtlas.Pixels();
+        staging.resize((size_t)w * h);
+        for (int row = 0; row < h; row++) {
+            const uint8_t* src = &pixels[(size_t)(y0 + row) * g_glyphAtlas.Width() + x0];
+            UINT32* dst = &staging[(size_t)row * w];
+            for (int col = 0; col < w; col++) dst[col] = src[col] * 0x01010101u;
+        }
+        D2D1_RECT_U rc = D2D1::RectU(x0, y0, x1, y1);
+        g_pGlyphAtlasBitmap->CopyFromMemory(&rc, staging.data(), w * 4);
+    }
+    return true;
+}
+
+static void DrawGlyphQuads(const std::vector<GlyphQuad>& quads) {
+    if (quads.empty() || !g_pSolidBrush) return;
+
+    // FillOpacityMask는 앨리어싱 모드에서만 동작합니다.
+    D2D1_ANTIALIAS_MODE oldMode = g_pRT->GetAntialiasMode();
+    g_pRT->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+    int atlasState = 0; // 0: 미확인, 1: 준비됨, -1: 실패
+    for (const auto& q : quads) {
+        // 글리프가 번지지 않도록 픽셀 단위로 맞춥니다.
+        float x = floorf(q.x + 0.5f), y = floorf(q.y + 0.5f);
+        D2D1_RECT_F dest = D2D1::RectF(x, y, x + q.w, y + q.h);
+        D2D1_RECT_F src = D2D1::RectF((float)q.sx, (float)q.sy, (float)(q.sx + q.sw), (float)(q.sy + q.sh));
+
+        if (q.page < 0) {
+            if (atlasState == 0) atlasState = SyncGlyphAtlas() ? 1 : -1;
+            if (atlasState > 0) {
+                g_pRT->FillOpacityMask(g_pGlyphAtlasBitmap, g_pSolidBrush,
+                    D2D1_OPACITY_MASK_CONTENT_TEXT_NATURAL, &dest, &src);
+            }
+        }
+        else if (q.page < (int)g_bitmapTable.size() && g_bitmapTable[q.page]) {
+            // BMFont 페이지는 원래 색을 유지하고 알파만 적용
+            g_pRT->DrawBitmap(g_bitmapTable[q.page], dest, g_d2dColor.a,
+                D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, src);
+        }
+    }
+
+    g_pRT->SetAntialiasMode(oldMode);
+}
+
+// 글리프 쿼드 전체를 감싸는 사각형 (DrawGlyphQuads의 픽셀 맞춤 여유 1px 포함)
+static D2D1_RECT_F QuadBounds(const std::vector<GlyphQuad>& quads) {
+    D2D1_RECT_F r = D2D1::RectF(quads[0].x, quads[0].y, quads[0].x, quads[0].y);
+    for (const auto& q : quads) {
+        r.left = (std::min)(r.left, q.x);
+        r.top = (std::min)(r.top, q.y);
+        r.right = (std::max)(r.right, q.x + q.w);
+        r.bottom = (std::max)(r.bottom, q.y + q.h);
+    }
+    return D2D1::RectF(r.left - 1.0f, r.top - 1.0f, r.right + 1.0f, r.bottom + 1.0f);
+}
+
+// Lua 숫자는 음수나 아주 큰 값이 올 수 있으므로 uint32로 넘기기 전에 자릅니다.
+static uint32_t ClampParticleCount(double n) {
+    if (!(n > 0.0)) return 0;
+    return (uint32_t)(std::min)(n, (double)ParticleEmitter::kMaxCount);
+}
+
+static void register_particles(sol::state& lua, sol::table& g) {
+    lua.new_usertype<ParticleEmitter>("ParticleEmitter",
+        "x", &ParticleEmitter::x,
+        "y", &ParticleEmitter::y,
+        "rate", &ParticleEmitter::rate,
+        "drag", &ParticleEmitter::drag,
+        "imageId", &ParticleEmitter::imageId,
+        "maxCount", sol::property(
+            [](const ParticleEmitter& e) { return e.maxCount; },
+            [](ParticleEmitter& e, double n) { e.maxCount = ClampParticleCount(n); }),
+        "count", sol::readonly(&ParticleEmitter::count),
+
+        // dt는 Update(dtms)와 같은 밀리초 단위
+        "update", [](ParticleEmitter& e, float dtms) { e.Update(dtms / 1000.0f); },
+        "emit", [](ParticleEmitter& e, int n) { if (n > 0) e.Emit((uint32_t)n); },
+        "clear", &ParticleEmitter::Clear,
+        "setSpread", [](ParticleEmitter& e, float sx, float sy) { e.spreadX = sx; e.spreadY = sy; },
+        "setLife", [](ParticleEmitter& e, float lo, sol::optional<float> hi) {
+            e.lifeMin = lo / 1000.0f; e.lifeMax = hi.value_or(lo) / 1000.0f;
+        },
+        "setSpeed", [](ParticleEmitter& e, float lo, sol::optional<float> hi) {
+            e.speedMin = lo; e.speedMax = hi.value_or(lo);
+        },
+        "setDirection", [](ParticleEmitter& e, float dir, sol::optional<float> spread) {
+            e.direction = dir; e.spread = spread.value_or(e.spread);
+        },
+        "setGravity", [](ParticleEmitter& e, float gx, float gy) { e.gravityX = gx; e.gravityY = gy; },
+        "setSpin", [](ParticleEmitter& e, float lo, sol::optional<float> hi) {
+            e.spinMin = lo; e.spinMax = hi.value_or(lo);
+        },
+        "setSizes", [](ParticleEmitter& e, float s0, sol::optional<float> s1) {
+            e.sizeStart = s0; e.sizeEnd = s1.value_or(s0);
+        },
+        // 색상은 g.color와 같은 0~255 범위, 수명 동안 시작 -> 끝으로 선형 보간 (중간 키는 없음)
+        "setColors", [](ParticleEmitter& e, int r0, int g0, int b0, int a0,
+            sol::optional<int> r1, sol::optional<int> g1, sol::optional<int> b1, sol::optional<int> a1) {
+            e.colorStart[0] = r0 / 255.0f; e.colorStart[1] = g0 / 255.0f;
+            e.colorStart[2] = b0 / 255.0f; e.colorStart[3] = a0 / 255.0f;
+            e.colorEnd[0] = r1.value_or(r0) / 255.0f; e.colorEnd[1] = g1.value_or(g0) / 255.0f;
+            e.colorEnd[2] = b1.value_or(b0) / 255.0f; e.colorEnd[3] = a1.value_or(0) / 255.0f;
+        }
+    );
+
+    // g.newParticles(imageId, { x=, y=, rate=, ... })
+    g["newParticles"] = [](sol::optional<int> imageId, sol::optional<sol::table> opts) {
+        auto e = std::make_shared<ParticleEmitter>();
+        e->imageId = imageId.value_or(-1);
+        if (opts) {
+            sol::table o = *opts;
+            e->x = o.get_or("x", e->x);
+            e->y = o.get_or("y", e->y);
+            e->rate = o.get_or("rate", e->rate);
+            e->drag = o.get_or("drag", e->drag);
+            e->maxCount = ClampParticleCount(o.get_or("maxCount", (double)e->maxCount));
+            e->gravityX = o.get_or("gravityX", e->gravityX);
+            e->gravityY = o.get_or("gravityY", e->gravityY);
+            e->speedMin = o.get_or("speedMin", e->speedMin);
+            e->speedMax = o.get_or("speedMax", e->speedMin);
+            e->lifeMin = o.get_or("lifeMin", e->lifeMin * 1000.0f) / 1000.0f;
+            e->lifeMax = o.get_or("lifeMax", e->lifeMin * 1000.0f) / 1000.0f;
+            e->direction = o.get_or("direction", e->direction);
+            e->spread = o.get_or("spread", e->spread);
+            e->sizeStart = o.get_or("sizeStart", e->sizeStart);
+            e->sizeEnd = o.get_or("sizeEnd", e->sizeStart);
+        }
+        return e;
+        };
+
+    // 에미터 하나를 한 번의 호출로 그립니다.
+    g["particles"] = [](ParticleEmitter& e) {
+        if (!g_pRT || e.count == 0) return;
+
+        ID2D1Bitmap* bmp = nullptr;
+        if (e.imageId >= 0 && e.imageId < (int)g_bitmapTable.size())
+            bmp = g_bitmapTable[e.imageId];
+
+        float aspect = 1.0f;
+        if (bmp) {
+            auto bs = bmp->GetSize();
+            if (bs.width > 0.0f) aspect = bs.height / bs.width;
+        }
+        else if (!g_pSolidBrush) {
+            return;
+        }
+
+        // 이미지 파티클은 색이 흰색이면 이미지를 그대로 그리고, 아니면 이미지의 알파만 마스크로 써서
+        // 파티클 색(color-over-life)으로 칠합니다. (DC 렌더 타깃에는 색 행렬 효과가 없어 곱하기 틴트 대신 마스크)
+        const bool tint = bmp && g_pSolidBrush &&
+            !(e.colorStart[0] == 1.0f && e.colorStart[1] == 1.0f && e.colorStart[2] == 1.0f &&
+              e.colorEnd[0] == 1.0f && e.colorEnd[1] == 1.0f && e.colorEnd[2] == 1.0f);
+        // FillOpacityMask는 앨리어싱 모드에서만 동작합니다.
+        const D2D1_ANTIALIAS_MODE oldMode = g_pRT->GetAntialiasMode();
+        if (tint) g_pRT->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+        const D2D1_MATRIX_3X2_F base = g_draw.matrix;
+        bool recolored = false;
+
+        for (uint32_t i = 0; i < e.count; i++) {
+            float hw = e.size[i] * 0.5f, hh = hw * aspect;
+            D2D1_RECT_F dest = D2D1::RectF(e.px[i] - hw, e.py[i] - hh, e.px[i] + hw, e.py[i] + hh);
+
+            // 회전이 있는 파티클만 행렬을 바꾸고, 화면 밖 파티클은 건너뜁니다.
+            bool visible;
+            if (e.rot[i] != 0.0f) {
+                visible = PrepareDraw(dest,
+                    D2D1::Matrix3x2F::Rotation(e.rot[i] * 57.2957795f, D2D1::Point2F(e.px[i], e.py[i])) * base);
+            }
+            else {
+                visible = PrepareDraw(dest, base);
+            }
+            if (!visible) continue;
+
+            if (tint) {
+                g_pSolidBrush->SetColor(D2D1::ColorF(e.r[i], e.g[i], e.b[i], e.a[i]));
+                g_pRT->FillOpacityMask(bmp, g_pSolidBrush, D2D1_OPACITY_MASK_CONTENT_GRAPHICS, &dest, nullptr);
+                recolored = true;
+            }
+            else if (bmp) {
+                g_pRT->DrawBitmap(bmp, dest, e.a[i], D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, nullptr);
+            }
+            else {
+                g_pSolidBrush->SetColor(D2D1::ColorF(e.r[i], e.g[i], e.b[i], e.a[i]));
+                g_pRT->FillRectangle(dest, g_pSolidBrush);
+                recolored = true;
+            }
+        }
+
+        if (recolored) g_pSolidBrush->SetColor(g_d2dColor);
+        if (tint) g_pRT->SetAntialiasMode(oldMode);
+        };
+}
+
+static void register_canvas(sol::state& lua, sol::table& g) {
+    lua.new_usertype<Canvas>("Canvas",
+        "width", sol::readonly(&Canvas::width),
+        "height", sol::readonly(&Canvas::height),
+        "image", sol::readonly(&Canvas::imageId),
+        // 스크립트가 true로 바꾸면 다시 그려야 한다는 표시, setCanvas(c) 하면 false
+        "dirty", &Canvas::dirty
+    );
+
+    // 캔버스로 전환/복귀할 때 그리기 대상과 변환/클립 상태를 바꿉니다.
+    g_canvases.onBegin = [](Canvas& c) {
+        g_mainDraw.Enter(g_draw);
+        g_pRT = static_cast<D2DCanvasSurface*>(c.surface.get())->target;
+        };
+    g_canvases.onEnd = [](Canvas&) {
+        PopClipsTo(0); // EndDraw 전에 캔버스에 쌓인 클립을 모두 해제
+        g_pRT = g_pDCRT;
+        g_mainDraw.Leave(g_draw);
+        };
+
+    g["newCanvas"] = [](int w, int h) {
+        const int imageId = (int)g_bitmapTable.size();
+        g_bitmapTable.push_back(nullptr);
+        return g_canvases.Create(w, h, imageId);
+        };
+
+    // g.setCanvas(c): 이후 그리기를 캔버스로, g.setCanvas(): 화면으로 복귀
+    g["setCanvas"] = [](sol::optional<Canvas&> canvas) {
+        if (canvas) g_canvases.Begin(*canvas); // 실패하면 화면에 그리는 상태로 남음
+        else g_canvases.End();
+        };
+
+    // 현재 그리기 대상 지우기 (기본값 투명)
+    g["clear"] = [](sol::optional<int> r, sol::optional<int> gr, sol::optional<int> b, sol::optional<int> a) {
+        if (!g_pRT) return;
+        ApplyPendingClips(); // Clear는 변환은 무시하지만 클립은 따릅니다.
+        g_pRT->Clear(D2D1::ColorF(r.value_or(0) / 255.0f, gr.value_or(0) / 255.0f,
+            b.value_or(0) / 255.0f, a.value_or(0) / 255.0f));
+        };
+}
+
+// 시트의 프레임 하나 그리기. (x, y)는 트리밍 전 원래 프레임의 왼쪽 위입니다.
+static void DrawSpriteFrame(const SpriteSheet& sheet, int frame, float x, float y, bool flip) {
+    if (!g_pRT || frame < 0 || frame >= (int)sheet.frames.size()) return;
+    if (sheet.imageId < 0 || sheet.imageId >= (int)g_bitmapTable.size()) return;
+    ID2D1Bitmap* bmp = g_bitmapTable[sheet.imageId];
+    if (!bmp) return;
+
+    const SpriteFrame& f = sheet.frames[frame];
+    D2D1_RECT_F destRect = D2D1::RectF(x + f.ox, y + f.oy, x + f.ox + f.sw, y + f.oy + f.sh);
+
+    // 좌우 반전은 원래 프레임 중앙 기준 (트리밍 여백이 달라도 발 위치가 유지됨)
+    D2D1_MATRIX_3X2_F transform = g_draw.matrix;
+    if (flip) {
+        transform = D2D1::Matrix3x2F::Scale(-1.0f, 1.0f, D2D1::Point2F(x + f.w / 2.0f, y + f.h / 2.0f)) * g_draw.matrix;
+    }
+    if (!PrepareDraw(destRect, transform)) return;
+
+    D2D1_RECT_F srcRect = D2D1::RectF(f.sx, f.sy, f.sx + f.sw, f.sy + f.sh);
+    g_pRT->DrawBitmap(bmp, destRect, 1.0f, D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, srcRect);
+}
+
+static const SpriteSheet* FindSheet(int sheetId) {
+    if (sheetId < 0 || sheetId >= (int)g_spriteSheets.size()) return nullptr;
+    return g_spriteSheets[sheetId].get();
+}
+
+static void register_anim(sol::state& lua, sol::table& g) {
+    // 프레임 번호는 Lua 관례대로 1부터, 시간은 Update(dtms)와 같은 ms
+    lua.new_usertype<Anim>("Anim",
+        sol::no_constructor,
+        "sheet", sol::readonly(&Anim::sheetId),
+        "frame", sol::property(
+            [](Anim& a) { AnimState* st = g_animPool.Get(a.handle); return st ? st->frame + 1 : 0; },
+            [](Anim& a, int frame) {
+                AnimState* st = g_animPool.Get(a.handle);
+                if (!st) return;
+                st->frame = (std::max)(st->from, (std::min)(st->to, frame - 1));
+                st->timeMs = 0.0f;
+            }),
+        "tag", sol::property([](Anim& a) -> std::string {
+            AnimState* st = g_animPool.Get(a.handle);
+            return (st && st->tag >= 0) ? st->sheet->tags[st->tag].name : std::string();
+            }),
+        "speed", sol::property(
+            [](Anim& a) { AnimState* st = g_animPool.Get(a.handle); return st ? st->speed : 0.0f; },
+            [](Anim& a, float speed) {
+                if (AnimState* st = g_animPool.Get(a.handle)) st->speed = (std::max)(0.0f, speed);
+            }),
+        "playing", sol::property(
+            [](Anim& a) { AnimState* st = g_animPool.Get(a.handle); return st && st->playing; },
+            [](Anim& a, bool playing) {
+                AnimState* st = g_animPool.Get(a.handle);
+                if (st && !st->done) st->playing = playing;
+            }),
+        "done", sol::property([](Anim& a) { AnimState* st = g_animPool.Get(a.handle); return st && st->done; }),
+        "loops", sol::property([](Anim& a) { AnimState* st = g_animPool.Get(a.handle); return st ? st->loops : 0u; }),
+        "width", sol::property([](Anim& a) {
+            AnimState* st = g_animPool.Get(a.handle); return st ? st->sheet->frames[st->frame].w : 0.0f;
+            }),
+        "height", sol::property([](Anim& a) {
+            AnimState* st = g_animPool.Get(a.handle); return st ? st->sheet->frames[st->frame].h : 0.0f;
+            }),
+
+        // anim:play(tag, loop): tag 생략 시 시트 전체, loop 생략 시 태그의 repeat 설정을 따름
+        "play", [](Anim& a, sol::optional<std::string> tag, sol::optional<bool> loop) {
+            AnimState* st = g_animPool.Get(a.handle);
+            if (!st) return false;
+
+            int tagIndex = -1;
+            if (tag) {
+                tagIndex = st->sheet->FindTag(*tag);
+                if (tagIndex < 0) return false;
+            }
+            AnimPool::Play(*st, tagIndex, loop ? (*loop ? 0 : 1) : -1);
+            return true;
+        }
+    );
+
+    // g.newAnim(sheetId, tag)
+    g["newAnim"] = [](int sheetId, sol::optional<std::string> tag) -> std::unique_ptr<Anim> {
+        const SpriteSheet* sheet = FindSheet(sheetId);
+        if (!sheet) return nullptr;
+
+        auto a = std::make_unique<Anim>();
+        a->sheetId = sheetId;
+        a->handle = g_animPool.Create(sheet, tag ? sheet->FindTag(*tag) : -1);
+        return a;
+        };
+
+    // g.drawAnim(anim, x, y, flipX): 현재 프레임을 한 번의 호출로 그립니다.
+    g["drawAnim"] = [](Anim& a, float x, float y, sol::optional<bool> flipX) {
+        AnimState* st = g_animPool.Get(a.handle);
+        if (st) DrawSpriteFrame(*st->sheet, st->frame, x, y, flipX.value_or(false));
+        };
+
+    // g.sprite(sheetId, frame, x, y, flipX): frame은 1부터 시작하는 번호 또는 프레임 이름
+    g["sprite"] = [](int sheetId, sol::object frame, float x, float y, sol::optional<bool> flipX) {
+        const SpriteSheet* sheet = FindSheet(sheetId);
+        if (!sheet) return;
+
+        int index = -1;
+        if (frame.is<int>()) index = frame.as<int>() - 1;
+        else if (frame.is<std::string>()) index = sheet->FindFrame(frame.as<std::string>());
+        DrawSpriteFrame(*sheet, index, x, y, flipX.value_or(false));
+        };
+}
 
 void register_draw(sol::state& lua, const char* name) {
-    g_pDCRT->CreateSolidColorBrush(g_d2dColor, &g_pSolidBrush);
+    g_pRT->CreateSolidColorBrush(g_d2dColor, &g_pSolidBrush);
 
     // 1. 테이블 생성 (기존 lua_newtable + lua_setglobal 대용)
     auto g = lua.create_named_table(name);
 
     // 2. Rect 그리기
     g["rect"] = [](float x, float y, float w, float h) {
-        if (g_pDCRT && g_pSolidBrush) {
+        if (g_pRT && g_pSolidBrush) {
+            D2D1_RECT_F rect = D2D1::RectF(x, y, x + w, y + h);
+            if (!PrepareDraw(rect)) return;
             g_pSolidBrush->SetColor(g_d2dColor); // 그리기 직전 색상 동기화
-            g_pDCRT->FillRectangle(D2D1::RectF(x, y, x + w, y + h), g_pSolidBrush);
+            g_pRT->FillRectangle(rect, g_pSolidBrush);
         }
     };
 
@@ -24,10 +522,10 @@ void register_draw(sol::state& lua, const char* name) {
     g["color"] = [](int r, int g, int b, sol::optional<int> a) {
         g_d2dColor = D2D1::ColorF(r / 255.0f, g / 255.0f, b / 255.0f, a.value_or(255) / 255.0f);
 
-        if (g_pDCRT) {
+        if (g_pRT) {
             if (g_pSolidBrush == nullptr) {
                 // 브러시가 처음일 때만 생성
-                g_pDCRT->CreateSolidColorBrush(g_d2dColor, &g_pSolidBrush);
+                g_pRT->CreateSolidColorBrush(g_d2dColor, &g_pSolidBrush);
             }
             else {
                 // 이미 있으면 색상만 변경 (이게 훨씬 빠릅니다)
@@ -37,17 +535,33 @@ void register_draw(sol::state& lua, const char* name) {
         };
 
     // 4. 텍스트 그리기
-    g["text"] = [](int fontId, std::string text, float x, float y) {
-        if (fontId >= 0 && fontId < (int)g_fontTable.size() && g_pDCRT) {
-            std::wstring wText = to_wstring(text);
+    g["text"] = [](int fontId, std::string_view text, float x, float y) {
+        if (fontId >= 0 && fontId < (int)g_fontTable.size() && g_pRT) {
+            // 글리프 캐시가 있으면 아틀라스 쿼드로 그립니다.
+            GlyphFont* glyphFont = g_glyphFontTable[fontId].get();
+            float w, h;
+            if (glyphFont && glyphFont->Layout(text, x, y, g_glyphQuads, w, h)) {
+                if (!g_glyphQuads.empty() && PrepareDraw(QuadBounds(g_glyphQuads)))
+                    DrawGlyphQuads(g_glyphQuads);
+                return;
+            }
+
+            // 캐시에 없는 글자(폰트 폴백 등)가 있으면 기존 DrawText 경로
             IDWriteTextFormat* pFormat = g_fontTable[fontId];
+            if (!pFormat) return;
+
+            // 레이아웃 없이 넉넉하게 잡은 영역 (바이트당 1em, 줄당 2em)으로 컬링
+            const float em = pFormat->GetFontSize();
+            const float lines = 1.0f + (float)std::count(text.begin(), text.end(), '\n');
+            if (!PrepareDraw(D2D1::RectF(x, y, x + em * (float)text.size(), y + em * 2.0f * lines))) return;
+            std::wstring wText = to_wstring(text);
 
             // D2D는 텍스트를 그릴 영역(Rect)을 지정해야 합니다.
             // x, y부터 시작해서 아주 넓은 영역을 잡아주면 GDI+처럼 동작합니다.
             D2D1_RECT_F layoutRect = D2D1::RectF(x, y, 10000.0f, 10000.0f);
 
             // 현재 설정된 전역 브러시(g_pSolidBrush)로 그리기
-            g_pDCRT->DrawText(
+            g_pRT->DrawText(
                 wText.c_str(),
                 (UINT32)wText.length(),
                 pFormat,
@@ -56,10 +570,17 @@ void register_draw(sol::state& lua, const char* name) {
             );
         }
     };
-    g["fontSize"] = [](int fontId, std::string text) -> std::pair<float, float> {
+    g["fontSize"] = [](int fontId, std::string_view text) -> std::pair<float, float> {
         if (fontId >= 0 && fontId < (int)g_fontTable.size()) {
-            std::wstring wText = to_wstring(text);
+            GlyphFont* glyphFont = g_glyphFontTable[fontId].get();
+            float gw, gh;
+            if (glyphFont && glyphFont->Layout(text, 0.0f, 0.0f, g_glyphQuads, gw, gh)) {
+                return { gw, gh };
+            }
+
             IDWriteTextFormat* pFormat = g_fontTable[fontId]; // IDWriteTextFormat* 저장된 테이블
+            if (!pFormat) return { 0.0f, 0.0f };
+            std::wstring wText = to_wstring(text);
 
             IDWriteTextLayout* pLayout = nullptr;
             g_pDWriteFactory->CreateTextLayout(wText.c_str(), wText.length(), pFormat, 10000.0f, 10000.0f, &pLayout);
@@ -82,88 +603,106 @@ void register_draw(sol::state& lua, const char* name) {
         sol::optional<float> sw, sol::optional<float> sh,
         sol::optional<bool> flipX) {
 
-            if (id < 0 || id >= (int)g_bitmapTable.size() || !g_pDCRT) return;
+            if (id < 0 || id >= (int)g_bitmapTable.size() || !g_pRT) return;
+            if (g_canvases.Active() && g_canvases.Active()->imageId == id) return; // 자기 자신에는 못 그림
 
             ID2D1Bitmap* bmp = g_bitmapTable[id];
+            if (!bmp) return; // 로드 실패 또는 아직 그려지지 않은 캔버스
             auto size = bmp->GetSize();
 
             float _dw = dw.value_or(size.width);
             float _dh = dh.value_or(size.height);
             bool _flip = flipX.value_or(false);
 
-            // 1. 기존 변환 행렬 백업
-            D2D1_MATRIX_3X2_F oldTransform;
-            g_pDCRT->GetTransform(&oldTransform);
-
-            // 2. 좌우 반전이 필요할 경우에만 일시적 행렬 적용
+            // 1. 좌우 반전이 필요할 경우에만 이번 그리기용 행렬 계산
+            D2D1_MATRIX_3X2_F transform = g_draw.matrix;
             if (_flip) {
                 // 캐릭터의 '현재 위치의 중앙'을 기준으로 반전시키는 행렬 계산
-                // 기존 행렬(oldTransform)에 반전 행렬을 곱해줍니다.
+                // 현재 행렬에 반전 행렬을 곱해줍니다. (렌더 타겟 반영은 PrepareDraw에서)
                 D2D1_MATRIX_3X2_F flipMatrix = D2D1::Matrix3x2F::Scale(
                     -1.0f, 1.0f,
                     D2D1::Point2F(dx + _dw / 2.0f, dy + _dh / 2.0f)
                 );
-                g_pDCRT->SetTransform(flipMatrix * oldTransform);
+                transform = flipMatrix * g_draw.matrix;
             }
 
-            // 3. 그리기 (srcRect는 정방향으로 설정)
+            // 2. 화면/클립 밖이면 건너뛰기
             D2D1_RECT_F destRect = D2D1::RectF(dx, dy, dx + _dw, dy + _dh);
+            if (!PrepareDraw(destRect, transform)) return;
+
+            // 3. 그리기 (srcRect는 정방향으로 설정)
             D2D1_RECT_F srcRect = D2D1::RectF(
                 sx.value_or(0.0f), sy.value_or(0.0f),
                 sx.value_or(0.0f) + sw.value_or(size.width),
                 sy.value_or(0.0f) + sh.value_or(size.height)
             );
 
-            g_pDCRT->DrawBitmap(bmp, destRect, 1.0f, D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, srcRect);
-
-            // 4. 원래 행렬로 즉시 복구 (매우 중요!)
-            if (_flip) {
-                g_pDCRT->SetTransform(oldTransform);
-            }
+            g_pRT->DrawBitmap(bmp, destRect, 1.0f, D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, srcRect);
         };
+    register_particles(lua, g);
+    register_canvas(lua, g);
+    register_anim(lua, g);
+
+    // 클립과 변환은 CPU 쪽 g_draw에만 쌓아 두고, 다음 그리기 때 렌더 타겟에 반영합니다.
     g["clip"] = [](float x, float y, float w, float h) {
-        g_pDCRT->PushAxisAlignedClip(D2D1::RectF(x, y, x + w, y + h), D2D1_ANTIALIAS_MODE_ALIASED);
-        g_clipCount++;
+        D2D1_RECT_F rect = D2D1::RectF(x, y, x + w, y + h);
+        D2D1_RECT_F b = TransformBounds(g_draw.matrix, rect);
+        D2D1_RECT_F parent = CullRect();
+        D2D1_RECT_F cull = D2D1::RectF(
+            (std::max)(b.left, parent.left), (std::max)(b.top, parent.top),
+            (std::min)(b.right, parent.right), (std::min)(b.bottom, parent.bottom));
+        g_draw.clips.push_back({ rect, g_draw.matrix, cull });
         };
 
     g["push"] = []() {
-        D2D1_MATRIX_3X2_F current;
-        g_pDCRT->GetTransform(&current);
-        g_stateStack.push_back({ current, g_clipCount });
+        g_draw.stack.push_back({ g_draw.matrix, (int)g_draw.clips.size() });
         };
 
     g["pop"] = []() {
-        if (g_stateStack.empty()) return;
+        if (g_draw.stack.empty()) return;
 
-        StateLayer last = g_stateStack.back();
-        g_stateStack.pop_back();
+        StateLayer last = g_draw.stack.back();
+        g_draw.stack.pop_back();
 
-        // 1. push했던 시점보다 더 많이 쌓인 클립들을 모두 해제
-        while (g_clipCount > last.clipDepth) {
-            g_pDCRT->PopAxisAlignedClip();
-            g_clipCount--;
-        }
+        // 1. push했던 시점보다 더 많이 쌓인 클립들을 해제 (실제로 push 된 것만 D2D에서 pop)
+        PopClipsTo((size_t)last.clipDepth);
 
         // 2. 변환 행렬 복구
-        g_pDCRT->SetTransform(last.matrix);
+        g_draw.matrix = last.matrix;
         };
 
     // 3. 이동 (Translate)
     g["translate"] = [](float x, float y) {
-        D2D1_MATRIX_3X2_F current, next;
-        g_pDCRT->GetTransform(&current);
-        next = current * D2D1::Matrix3x2F::Translation(x, y);
-        g_pDCRT->SetTransform(next);
+        g_draw.matrix = g_draw.matrix * D2D1::Matrix3x2F::Translation(x, y);
         };
 
     // 4. 확대/축소 (Scale)
     g["scale"] = [](float sx, float sy, sol::optional<float> ox, sol::optional<float> oy) {
-        D2D1_MATRIX_3X2_F current, next;
-        g_pDCRT->GetTransform(&current);
-
         // 중심점(ox, oy)이 주어지면 그 지점을 기준으로 확대, 아니면 (0,0) 기준
         D2D1_POINT_2F center = D2D1::Point2F(ox.value_or(0.0f), oy.value_or(0.0f));
-        next = current * D2D1::Matrix3x2F::Scale(sx, sy, center);
-        g_pDCRT->SetTransform(next);
+        g_draw.matrix = g_draw.matrix * D2D1::Matrix3x2F::Scale(sx, sy, center);
+        };
+
+    // 5. 회전 (라디안, 중심점 선택)
+    g["rotate"] = [](float rad, sol::optional<float> ox, sol::optional<float> oy) {
+        D2D1_POINT_2F center = D2D1::Point2F(ox.value_or(0.0f), oy.value_or(0.0f));
+        g_draw.matrix = g_draw.matrix * D2D1::Matrix3x2F::Rotation(rad * 57.2957795f, center);
+        };
+
+    // 6. 기울이기: x' = x + kx * y, y' = y + ky * x
+    g["shear"] = [](float kx, sol::optional<float> ky) {
+        D2D1::Matrix3x2F shear(1.0f, ky.value_or(0.0f), kx, 1.0f, 0.0f, 0.0f);
+        g_draw.matrix = g_draw.matrix * shear;
+        };
+
+    // 직전 프레임 그리기 통계 (컬링된 수, 렌더 타겟 상태 변경 수)
+    g["stats"] = [](sol::this_state s) {
+        sol::state_view lua(s);
+        sol::table t = lua.create_table();
+        t["drawn"] = g_lastDrawStats.drawn;
+        t["culled"] = g_lastDrawStats.culled;
+        t["transforms"] = g_lastDrawStats.transforms;
+        t["clips"] = g_lastDrawStats.clips;
+        return t;
         };
-}
\ No newline at end of file
+}
@@ -1,6 +1,47 @@
 ﻿#include "lua_engine.h"
+#include "hit_index.h"
 #include <tuple>
 
+// is.setHitIndex로 지정한 인덱스. 마우스 핸들러에 넘길 위젯 id와 클릭 통과 여부를 정합니다.
+static std::shared_ptr<HitIndex> g_hitIndex;
+static bool g_hitPassThrough = false;
+static bool g_clickThrough = false; // 현재 창에 WS_EX_TRANSPARENT가 붙어 있음
+
+sol::object MouseHitId(int x, int y) {
+    int id;
+    if (g_hitIndex && g_hitIndex->Hit((float)x, (float)y, id)) return sol::make_object(lua, id);
+    return sol::lua_nil;
+}
+
+static void SetClickThrough(bool transparent) {
+    if (!g_hwnd || transparent == g_clickThrough) return;
+    LONG_PTR ex = GetWindowLongPtr(g_hwnd, GWL_EXSTYLE);
+    SetWindowLongPtr(g_hwnd, GWL_EXSTYLE, transparent ? (ex | WS_EX_TRANSPARENT) : (ex & ~(LONG_PTR)WS_EX_TRANSPARENT));
+    g_clickThrough = transparent;
+}
+
+// 매 프레임 커서 위치를 보고 빈 곳이면 클릭이 뒤 창으로 통과하도록 합니다.
+// (WS_EX_TRANSPARENT 중에는 마우스 메시지가 오지 않으므로 폴링)
+void UpdateClickThrough() {
+    if (!g_hitIndex || !g_hitPassThrough) {
+        SetClickThrough(false);
+        return;
+    }
+    // 드래그 중에는 바꾸지 않음
+    if ((GetAsyncKeyState(VK_LBUTTON) & 0x8000) || (GetAsyncKeyState(VK_RBUTTON) & 0x8000)) return;
+
+    POINT pt;
+    GetCursorPos(&pt);
+    ScreenToClient(g_hwnd, &pt);
+    SetClickThrough(!g_hitIndex->Interactive((float)pt.x, (float)pt.y));
+}
+
+void ResetHitIndex() {
+    g_hitIndex.reset();
+    g_hitPassThrough = false;
+    SetClickThrough(false);
+}
+
 void register_input(sol::state& lua, const char* name) {
     auto i = lua.create_named_table(name);
 
@@ -22,4 +63,40 @@ void register_input(sol::state& lua, const char* name) {
 
         return std::make_tuple(pt.x, pt.y, left, right);
     };
+
+    // 3. 히트 인덱스: 위젯 사각형을 id와 z로 등록해 두고 점으로 찾기
+    lua.new_usertype<HitIndex>("HitIndex",
+        sol::no_constructor,
+        "add", [](HitIndex& idx, int id, float x, float y, float w, float h, sol::optional<int> z) {
+            idx.Set(id, x, y, w, h, z.value_or(0));
+        },
+        // z를 생략하면 기존 z 유지. 없는 id면 false
+        "update", [](HitIndex& idx, int id, float x, float y, float w, float h, sol::optional<int> z) {
+            if (!idx.Has(id)) return false;
+            if (z) idx.Set(id, x, y, w, h, *z);
+            else idx.Move(id, x, y, w, h);
+            return true;
+        },
+        "remove", &HitIndex::Remove,
+        "clear", &HitIndex::Clear,
+        "hit", [](HitIndex& idx, float x, float y) -> sol::optional<int> {
+            int id;
+            if (idx.Hit(x, y, id)) return id;
+            return sol::nullopt;
+        },
+        "interactive", &HitIndex::Interactive,
+        "count", sol::property(&HitIndex::Count)
+    );
+
+    i["newHitIndex"] = [](sol::optional<float> cellSize) {
+        return std::make_shared<HitIndex>(cellSize.value_or(64.0f));
+    };
+
+    // is.setHitIndex(idx, passThrough): OnMouseDown 등 핸들러의 3번째 인자로 맨 위 위젯 id를 넘깁니다.
+    // passThrough가 true면 인덱스에 없는 곳의 클릭은 뒤 창으로 통과합니다. 인자 없이 부르면 해제
+    i["setHitIndex"] = [](sol::optional<std::shared_ptr<HitIndex>> idx, sol::optional<bool> passThrough) {
+        g_hitIndex = idx.value_or(nullptr);
+        g_hitPassThrough = g_hitIndex && passThrough.value_or(false);
+        if (!g_hitPassThrough) SetClickThrough(false);
+    };
 }
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "lua_engine.h"
+#include "nav_grid.h"
+#include <algorithm>
+#include <unordered_map>
+
+// res.navGrid: 격자 길찾기 (nav_grid.h)
+// A*와 흐름장은 격자 스냅샷을 들고 작업 스레드에서 풀고, 결과는 읽은 청크 버전과 함께 격자별로 캐시합니다.
+// 격자를 고치면 바뀐 청크를 읽었던 결과만 다시 계산합니다.
+
+static size_t NavWorkerCount() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 2 ? (std::min)(n - 1, 4u) : 1; // 메인 스레드 몫은 남겨 둠
+}
+static NavWorkers g_navWorkers(NavWorkerCount());
+
+constexpr size_t kMaxCachedPaths = 1024;
+constexpr size_t kMaxCachedFlowBytes = (size_t)64 << 20; // 흐름장은 칸마다 5바이트라 개수 대신 바이트로 제한
+
+// 캐시 한도에 세는 양. 경로는 개수, 흐름장은 바이트
+static size_t CacheCost(const NavPath&) { return 1; }
+static size_t CacheCost(const NavFlowField& f) { return f.dist.size() * sizeof(uint32_t) + f.dir.size(); }
+
+template <class T>
+struct NavCache {
+    std::unordered_map<uint64_t, std::shared_ptr<const T>> entries;
+    size_t cost = 0; // entries의 CacheCost 합
+
+    typename std::unordered_map<uint64_t, std::shared_ptr<const T>>::iterator Erase(
+        typename std::unordered_map<uint64_t, std::shared_ptr<const T>>::iterator it) {
+        cost -= CacheCost(*it->second);
+        return entries.erase(it);
+    }
+    void Clear() {
+        entries.clear();
+        cost = 0;
+    }
+};
+
+struct FlowTask;
+
+struct LuaNavGrid : public std::enable_shared_from_this<LuaNavGrid> {
+    NavGrid grid;
+    bool diagonal = true;
+    uint32_t generation = 0; // diagonal을 바꾸면 증가. 이전 설정으로 돌던 결과는 캐시에 넣지 않음
+
+    NavCache<NavPath> paths;
+    NavCache<NavFlowField> flows;
+    std::unordered_map<uint64_t, std::weak_ptr<FlowTask>> pendingFlows; // 같은 목표는 작업 하나를 같이 기다림
+    uint64_t hits = 0, misses = 0;
+
+    LuaNavGrid(int w, int h) : grid(w, h) {}
+
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < grid.Width() && y < grid.Height(); }
+    void ClearCache() {
+        paths.Clear();
+        flows.Clear();
+        pendingFlows.clear();
+    }
+};
+
+// Lua가 들고 다니는 흐름장. 격자가 바뀌어도 계산했던 시점의 결과를 그대로 들고 있습니다.
+struct FlowField {
+    std::shared_ptr<const NavFlowField> field;
+    std::weak_ptr<LuaNavGrid> owner;
+};
+
+static uint64_t PathKey(int sx, int sy, int tx, int ty) {
+    return ((uint64_t)(uint16_t)sx << 48) | ((uint64_t)(uint16_t)sy << 32) | ((uint64_t)(uint16_t)tx << 16) | (uint16_t)ty;
+}
+static uint64_t GoalKey(int tx, int ty) {
+    return ((uint64_t)(uint16_t)tx << 16) | (uint16_t)ty;
+}
+
+// 캐시된 결과가 읽었던 청크가 그대로면 재사용
+template <class T>
+static std::shared_ptr<const T> FindCached(LuaNavGrid& nav, NavCache<T>& cache, uint64_t key) {
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end() && nav.grid.IsCurrent(it->second->deps)) {
+        nav.hits++;
+        return it->second;
+    }
+    if (it != cache.entries.end()) cache.Erase(it);
+    nav.misses++;
+    return nullptr;
+}
+
+// maxCost는 CacheCost 단위. 혼자서 한도를 넘는 결과는 넣지 않습니다.
+template <class T>
+static void StoreCached(LuaNavGrid& nav, NavCache<T>& cache, uint64_t key, std::shared_ptr<const T> value, size_t maxCost) {
+    const size_t cost = CacheCost(*value);
+    if (cost > maxCost) return;
+    if (auto it = cache.entries.find(key); it != cache.entries.end()) cache.Erase(it);
+    if (cache.cost + cost > maxCost) {
+        // 오래된 결과부터 버리고, 그래도 넘치면 통째로 비움
+        for (auto it = cache.entries.begin(); it != cache.entries.end();) {
+            if (nav.grid.IsCurrent(it->second->deps)) ++it;
+            else it = cache.Erase(it);
+        }
+        if (cache.cost + cost > maxCost) cache.Clear();
+    }
+    cache.cost += cost;
+    cache.entries.emplace(key, std::move(value));
+}
+
+// 경로 -> { x1, y1, x2, y2, ... } (출발점과 도착점 포함), 없으면 nil
+static sol::object PathToLua(const NavPath& path, sol::state_view lua) {
+    if (!path.found) return sol::nil;
+    sol::table t = lua.create_table((int)path.points.size(), 0);
+    for (size_t i = 0; i < path.points.size(); i++) t.raw_set(i + 1, path.points[i]);
+    return t;
+}
+
+struct PathTask : public ITask {
+    std::weak_ptr<LuaNavGrid> owner;
+    uint64_t key = 0;
+    uint32_t generation = 0;
+    std::future<std::shared_ptr<const NavPath>> fuel;
+    sol::object result = sol::nil;
+
+    bool check(sol::this_state s) override {
+        if (isDone) return true;
+        if (!fuel.valid() || fuel.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+        std::shared_ptr<const NavPath> path = fuel.get();
+        if (auto nav = owner.lock(); nav && nav->generation == generation)
+            StoreCached(*nav, nav->paths, key, path, kMaxCachedPaths);
+        result = PathToLua(*path, s);
+        isDone = true;
+        return true;
+    }
+
+    sol::object getResult() override {
+        return result;
+    }
+};
+
+struct FlowTask : public ITask {
+    std::weak_ptr<LuaNavGrid> owner;
+    uint64_t key = 0;
+    uint32_t generation = 0;
+    uint32_t gridVersion = 0; // 스냅샷을 뜰 때의 격자 버전. 그 뒤로 고쳤으면 같이 기다리지 않음
+    std::future<std::shared_ptr<const NavFlowField>> fuel;
+    sol::object result = sol::nil;
+
+    bool check(sol::this_state s) override {
+        if (isDone) return true;
+        if (!fuel.valid() || fuel.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+        std::shared_ptr<const NavFlowField> field = fuel.get();
+        if (auto nav = owner.lock(); nav && nav->generation == generation) {
+            StoreCached(*nav, nav->flows, key, field, kMaxCachedFlowBytes);
+            // 같은 목표로 더 새 작업이 걸려 있으면 그대로 둠
+            auto pending = nav->pendingFlows.find(key);
+            if (pending != nav->pendingFlows.end() && pending->second.lock().get() == this) nav->pendingFlows.erase(pending);
+        }
+        result = sol::make_object(s, FlowField{ std::move(field), owner });
+        isDone = true;
+        return true;
+    }
+
+    sol::object getResult() override {
+        return result;
+    }
+};
+
+// 작업 스레드에서 풀고, 결과를 채운 뒤 완료를 통지 (JsonTask와 같은 순서)
+template <class Result, class Solve>
+static std::future<std::shared_ptr<const Result>> SubmitNavJob(std::weak_ptr<ITask> weak, Solve solve) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<const Result>>>();
+    auto future = promise->get_future();
+    g_navWorkers.Submit([promise, weak, solve = std::move(solve)]() {
+        promise->set_value(std::make_shared<const Result>(solve()));
+        NotifyTaskReady(weak);
+        });
+    return future;
+}
+
+static std::shared_ptr<ITask> FindPathAsync(LuaNavGrid& nav, int sx, int sy, int tx, int ty, sol::this_state s) {
+    auto task = std::make_shared<PathTask>();
+    task->owner = nav.weak_from_this();
+    task->key = PathKey(sx, sy, tx, ty);
+    task->generation = nav.generation;
+
+    // 1. 범위 밖이거나 캐시에 있으면 바로 끝난 태스크
+    if (!nav.InBounds(sx, sy) || !nav.InBounds(tx, ty)) {
+        task->isDone = true;
+        return task;
+    }
+    if (auto cached = FindCached(nav, nav.paths, task->key)) {
+        task->result = PathToLua(*cached, s);
+        task->isDone = true;
+        return task;
+    }
+
+    // 2. 스냅샷을 들고 작업 스레드로
+    const bool diagonal = nav.diagonal;
+    task->fuel = SubmitNavJob<NavPath>(task, [snap = nav.grid.Snapshot(), sx, sy, tx, ty, diagonal]() {
+        return FindNavPath(*snap, sx, sy, tx, ty, diagonal);
+        });
+    return task;
+}
+
+static std::shared_ptr<ITask> FlowFieldAsync(LuaNavGrid& nav, int tx, int ty, sol::this_state s) {
+    const uint64_t key = GoalKey(tx, ty);
+
+    // 1. 같은 목표로 같은 격자를 두고 이미 돌고 있으면 그 태스크를 같이 기다림
+    auto pending = nav.pendingFlows.find(key);
+    if (pending != nav.pendingFlows.end()) {
+        auto running = pending->second.lock();
+        if (running && running->generation == nav.generation && running->gridVersion == nav.grid.Version()) return running;
+        nav.pendingFlows.erase(pending);
+    }
+
+    auto task = std::make_shared<FlowTask>();
+    task->owner = nav.weak_from_this();
+    task->key = key;
+    task->generation = nav.generation;
+    task->gridVersion = nav.grid.Version();
+    if (!nav.InBounds(tx, ty)) {
+        task->isDone = true;
+        return task;
+    }
+    if (auto cached = FindCached(nav, nav.flows, key)) {
+        task->result = sol::make_object(s, FlowField{ cached, task->owner });
+        task->isDone = true;
+        return task;
+    }
+
+    // 2. 스냅샷을 들고 작업 스레드로
+    const bool diagonal = nav.diagonal;
+    task->fuel = SubmitNavJob<NavFlowField>(task, [snap = nav.grid.Snapshot(), tx, ty, diagonal]() {
+        return BuildNavFlowField(*snap, tx, ty, diagonal);
+        });
+    nav.pendingFlows[key] = task;
+    return task;
+}
+
+// res.navGrid(layer, { blocked = { 1, 2, ... } }): Tiled 타일 레이어(width, height, data)에서 생성
+// blocked를 주면 그 타일 id만, 안 주면 0이 아닌 타일은 모두 막힌 칸
+static std::shared_ptr<LuaNavGrid> NavGridFromLayer(const nlohmann::json& layer, sol::object opts) {
+    // 숫자가 아니거나 int 범위를 넘는 값은 0으로 보고 아래에서 걸러냄
+    auto dim = [&](const char* key) {
+        auto it = layer.find(key);
+        return (it != layer.end() && it->is_number_integer() && it->get<int64_t>() > 0 && it->get<int64_t>() <= 0xFFFF)
+            ? (int)it->get<int64_t>() : 0;
+        };
+    const int w = dim("width"), h = dim("height");
+    auto data = layer.find("data");
+    if (w <= 0 || h <= 0 || data == layer.end() || !data->is_array()) {
+        printf("[Resource Error] navGrid: layer needs width, height and an uncompressed data array\n");
+        return nullptr;
+    }
+    if (!NavGridSizeOk(w, h)) {
+        printf("[Resource Error] navGrid: %dx%d exceeds %zu cells\n", w, h, kNavMaxCells);
+        return nullptr;
+    }
+
+    std::vector<uint32_t> blockedIds;
+    if (opts.get_type() == sol::type::table) {
+        sol::optional<sol::table> ids = opts.as<sol::table>()["blocked"];
+        if (ids) {
+            for (size_t i = 1; i <= ids->size(); i++) blockedIds.push_back(ids->get_or<uint32_t>(i, 0));
+        }
+    }
+
+    auto nav = std::make_shared<LuaNavGrid>(w, h);
+    const size_t count = (std::min)(data->size(), (size_t)w * h);
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t gid = (*data)[i].is_number_unsigned() ? (*data)[i].get<uint32_t>() & 0x1FFFFFFF : 0; // 뒤집기 플래그 제거
+        const bool blocked = blockedIds.empty()
+            ? gid != 0
+            : std::find(blockedIds.begin(), blockedIds.end(), gid) != blockedIds.end();
+        if (blocked) nav->grid.Set((int)(i % w), (int)(i / w), true);
+    }
+    return nav;
+}
+
+// 경로 표는 매번 새로 만들어 돌려주므로 Lua에서 고쳐도 캐시는 그대로입니다.
+void register_nav(sol::state& lua, sol::table& res) {
+    lua.new_usertype<FlowField>("FlowField",
+        sol::no_constructor,
+        "goalX", sol::property([](FlowField& f) { return f.field->goalX; }),
+        "goalY", sol::property([](FlowField& f) { return f.field->goalY; }),
+        // 계산한 뒤로 격자가 (읽은 범위 안에서) 바뀌지 않았는지
+        "valid", sol::property([](FlowField& f) {
+            auto nav = f.owner.lock();
+            return nav && nav->grid.IsCurrent(f.field->deps);
+        }),
+        // ff:dir(x, y) -> dx, dy. 목표이거나 갈 수 없는 칸이면 0, 0
+        "dir", [](FlowField& f, int x, int y) {
+            int dx = 0, dy = 0;
+            const NavFlowField& field = *f.field;
+            if (x >= 0 && y >= 0 && x < field.width && y < field.height)
+                NavDirection(field.dir[(size_t)y * field.width + x], dx, dy);
+            return std::make_tuple(dx, dy);
+        },
+        // ff:dist(x, y) -> 목표까지 거리(칸, 대각선 1.4), 갈 수 없으면 nil
+        "dist", [](FlowField& f, int x, int y) -> sol::optional<double> {
+            const NavFlowField& field = *f.field;
+            if (x < 0 || y < 0 || x >= field.width || y >= field.height) return sol::nullopt;
+            const uint32_t d = field.dist[(size_t)y * field.width + x];
+            if (d == NavFlowField::kUnreachable) return sol::nullopt;
+            return d / 10.0;
+        }
+    );
+
+    lua.new_usertype<LuaNavGrid>("NavGrid",
+        sol::no_constructor,
+        "width", sol::property([](LuaNavGrid& n) { return n.grid.Width(); }),
+        "height", sol::property([](LuaNavGrid& n) { return n.grid.Height(); }),
+        "version", sol::property([](LuaNavGrid& n) { return n.grid.Version(); }),
+        "diagonal", sol::property(
+            [](LuaNavGrid& n) { return n.diagonal; },
+            [](LuaNavGrid& n, bool diagonal) {
+                if (n.diagonal == diagonal) return;
+                n.diagonal = diagonal;
+                n.generation++;
+                n.ClearCache();
+            }),
+
+        // 1. 편집 (좌표는 0부터)
+        "blocked", [](LuaNavGrid& n, int x, int y) { return n.grid.Blocked(x, y); },
+        "set", [](LuaNavGrid& n, int x, int y, bool blocked) { n.grid.Set(x, y, blocked); },
+        "fill", [](LuaNavGrid& n, int x, int y, int w, int h, bool blocked) { n.grid.Fill(x, y, w, h, blocked); },
+
+        // 2. A*: { x1, y1, x2, y2, ... } 또는 nil
+        "find", [](LuaNavGrid& n, int sx, int sy, int tx, int ty, sol::this_state s) -> sol::object {
+            if (!n.InBounds(sx, sy) || !n.InBounds(tx, ty)) return sol::nil;
+            const uint64_t key = PathKey(sx, sy, tx, ty);
+            auto path = FindCached(n, n.paths, key);
+            if (!path) {
+                path = std::make_shared<const NavPath>(FindNavPath(*n.grid.Snapshot(), sx, sy, tx, ty, n.diagonal));
+                StoreCached(n, n.paths, key, path, kMaxCachedPaths);
+            }
+            return PathToLua(*path, s);
+        },
+        "findAsync", [](LuaNavGrid& n, int sx, int sy, int tx, int ty, sol::this_state s) {
+            return FindPathAsync(n, sx, sy, tx, ty, s);
+        },
+
+        // 3. 흐름장: 같은 목표로 가는 유닛들이 ff:dir(x, y)만 따라가면 됨
+        "flowField", [](LuaNavGrid& n, int tx, int ty, sol::this_state s) -> sol::object {
+            if (!n.InBounds(tx, ty)) return sol::nil;
+            const uint64_t key = GoalKey(tx, ty);
+            auto field = FindCached(n, n.flows, key);
+            if (!field) {
+                field = std::make_shared<const NavFlowField>(BuildNavFlowField(*n.grid.Snapshot(), tx, ty, n.diagonal));
+                StoreCached(n, n.flows, key, field, kMaxCachedFlowBytes);
+            }
+            return sol::make_object(s, FlowField{ std::move(field), n.weak_from_this() });
+        },
+        "flowFieldAsync", [](LuaNavGrid& n, int tx, int ty, sol::this_state s) {
+            return FlowFieldAsync(n, tx, ty, s);
+        },
+
+        "stats", [](LuaNavGrid& n, sol::this_state s) {
+            sol::state_view lua(s);
+            sol::table t = lua.create_table();
+            t["paths"] = n.paths.entries.size();
+            t["flowFields"] = n.flows.entries.size();
+            t["flowFieldBytes"] = n.flows.cost;
+            t["hits"] = n.hits;
+            t["misses"] = n.misses;
+            t["queued"] = g_navWorkers.Pending();
+            return t;
+        }
+    );
+
+    // res.navGrid(w, h[, cells]): cells는 행 우선 1차원 표 (0/false = 지나갈 수 있음)
+    // res.navGrid(layer[, opts]): JSON 타일 레이어
+    res["navGrid"] = [](sol::object src, sol::object arg2, sol::object arg3) -> std::shared_ptr<LuaNavGrid> {
+        if (src.is<JsonNode>()) {
+            const JsonNode& node = src.as<JsonNode&>();
+            if (!node.node || !node.node->is_object()) {
+                printf("[Resource Error] navGrid: layer must be a JSON object\n");
+                return nullptr;
+            }
+            return NavGridFromLayer(*node.node, arg2);
+        }
+
+        const int w = src.is<int>() ? src.as<int>() : 0;
+        const int h = arg2.is<int>() ? arg2.as<int>() : 0;
+        if (!NavGridSizeOk(w, h)) {
+            printf("[Resource Error] navGrid: invalid size (1~65535 per side, at most %zu cells)\n", kNavMaxCells);
+            return nullptr;
+        }
+        auto nav = std::make_shared<LuaNavGrid>(w, h);
+        if (arg3.get_type() == sol::type::table) {
+            sol::table cells = arg3.as<sol::table>();
+            const size_t count = (size_t)w * h;
+            for (size_t i = 0; i < count; i++) {
+                sol::object v = cells.raw_get<sol::object>(i + 1);
+                const bool blocked = v.get_type() == sol::type::number ? v.as<double>() != 0.0
+                    : v.get_type() == sol::type::boolean && v.as<bool>();
+                if (blocked) nav->grid.Set((int)(i % w), (int)(i / w), true);
+            }
+        }
+        return nav;
+        };
+}
+
+void StopNavWorkers() {
+    // 남은 작업은 버리고 돌던 것만 기다림. 다시 Submit하면 스레드가 새로 뜹니다.
+    // 스레드가 끝나면서 thread_local 탐색 버퍼도 같이 풀립니다.
+    g_navWorkers.Stop();
+}
@@ -1,4 +1,5 @@
 #include "lua_engine.h"
+#include <dwrite_1.h> // 커닝 조회용 IDWriteFontFace1
 
 // 전역 변수 초기화 (기존 유지)
 Color g_currentColor(255, 255, 255, 255);
@@ -6,6 +7,10 @@ std::vector<ID2D1Bitmap*> g_bitmapTable;
 std::map<std::string, int> g_pathCache;
 std::vector<IDWriteTextFormat*> g_fontTable;
 std::vector<std::wstring> g_fontFamilyTable;
+GlyphAtlas g_glyphAtlas(1024, 1024);
+std::vector<std::unique_ptr<GlyphFont>> g_glyphFontTable;
+std::vector<std::unique_ptr<SpriteSheet>> g_spriteSheets;
+static std::map<std::string, int> g_spriteSheetCache; // "이미지 경로\njson 경로" -> g_spriteSheets 인덱스
 static std::unordered_map<std::string, std::unique_ptr<nlohmann::json>> g_JsonCache;
 static std::mutex g_JsonMutex;
 
@@ -65,6 +70,7 @@ void unregisterLuaFunctions() {
         RemoveFontResourceExW(fontPath.c_str(), FR_PRIVATE, 0);
 	}
     g_fontTable.clear();
+    g_glyphFontTable.clear();
     g_bitmapTable.clear();
     g_pathCache.clear();
 }
@@ -73,6 +79,12 @@ void RebuildAllBitmaps() {
     for (auto& bmp : g_bitmapTable) {
         SafeRelease(&bmp);
     }
+    // 글리프 아틀라스는 CPU 사본이 있으므로 다음 그리기 때 통째로 다시 올립니다.
+    SafeRelease(&g_pGlyphAtlasBitmap);
+    g_glyphAtlas.MarkAllDirty();
+    // 캔버스는 내용이 사라지므로 dirty 표시만 하고 다음 setCanvas 때 다시 만듭니다.
+    g_canvases.DeviceLost();
+
     for (const auto& [path, index]: g_pathCache) {
         if (index < 0 || index >= (int)g_bitmapTable.size())
             continue; // 방어
@@ -82,6 +94,431 @@ void RebuildAllBitmaps() {
     }
 }
 
+int LoadImageCached(const std::string& path) {
+    auto it = g_pathCache.find(path);
+    if (it != g_pathCache.end())
+        return it->second;
+
+    ID2D1Bitmap* pBitmap = LoadBitmapFromFile(g_pDCRT, path);
+    if (!pBitmap)
+        return -1;
+
+    int newID = (int)g_bitmapTable.size();
+    g_bitmapTable.push_back(pBitmap);
+    g_pathCache[path] = newID;
+    return newID;
+}
+
+// res.fontFile로 읽은 .ttf 하나짜리 DirectWrite 폰트 컬렉션
+// AddFontResourceEx(FR_PRIVATE)로 등록한 폰트는 GDI에만 보이고 시스템 컬렉션에는 없으므로,
+// 파일 경로를 키로 하는 컬렉션 로더를 팩토리에 등록해서 TextFormat과 글리프 폰트가 같은 컬렉션을 씁니다.
+class FontFileEnumerator : public IDWriteFontFileEnumerator {
+public:
+    explicit FontFileEnumerator(std::wstring path) : path(std::move(path)) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void** out) override {
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontFileEnumerator)) {
+            *out = this;
+            AddRef();
+            return S_OK;
+        }
+        *out = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&refs); }
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG n = InterlockedDecrement(&refs);
+        if (n == 0) delete this;
+        return n;
+    }
+
+    // 파일은 하나뿐이라 첫 MoveNext에서만 true
+    HRESULT STDMETHODCALLTYPE MoveNext(BOOL* hasCurrent) override {
+        *hasCurrent = FALSE;
+        if (moved) return S_OK;
+        moved = true;
+        HRESULT hr = g_pDWriteFactory->CreateFontFileReference(path.c_str(), nullptr, &current);
+        *hasCurrent = SUCCEEDED(hr);
+        return hr;
+    }
+    HRESULT STDMETHODCALLTYPE GetCurrentFontFile(IDWriteFontFile** out) override {
+        *out = current;
+        if (!current) return E_FAIL;
+        current->AddRef();
+        return S_OK;
+    }
+
+private:
+    ~FontFileEnumerator() { SafeRelease(&current); }
+
+    ULONG refs = 1;
+    std::wstring path;
+    bool moved = false;
+    IDWriteFontFile* current = nullptr;
+};
+
+// 상태가 없는 로더라 정적 객체 하나를 등록해 두고 참조 횟수는 세지 않습니다.
+class FontFileCollectionLoader : public IDWriteFontCollectionLoader {
+public:
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void** out) override {
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(IDWriteFontCollectionLoader)) {
+            *out = this;
+            return S_OK;
+        }
+        *out = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+    ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+    // 키 = 널 문자를 뺀 파일 경로 (WCHAR 배열)
+    HRESULT STDMETHODCALLTYPE CreateEnumeratorFromKey(IDWriteFactory*, const void* key, UINT32 keySize,
+        IDWriteFontFileEnumerator** out) override {
+        *out = new FontFileEnumerator(std::wstring((const WCHAR*)key, keySize / sizeof(WCHAR)));
+        return S_OK;
+    }
+};
+static FontFileCollectionLoader g_fontFileLoader;
+static bool g_fontFileLoaderRegistered = false;
+
+// 실패하면 nullptr (호출한 쪽은 시스템 컬렉션으로 대신합니다)
+static IDWriteFontCollection* CreateFontFileCollection(const std::wstring& path) {
+    if (!g_fontFileLoaderRegistered) {
+        if (FAILED(g_pDWriteFactory->RegisterFontCollectionLoader(&g_fontFileLoader))) return nullptr;
+        g_fontFileLoaderRegistered = true;
+    }
+    IDWriteFontCollection* pCollection = nullptr;
+    g_pDWriteFactory->CreateCustomFontCollection(&g_fontFileLoader,
+        path.data(), (UINT32)(path.size() * sizeof(WCHAR)), &pCollection);
+    return pCollection;
+}
+
+void ReleaseFontFileLoader() {
+    if (!g_fontFileLoaderRegistered || !g_pDWriteFactory) return;
+    g_pDWriteFactory->UnregisterFontCollectionLoader(&g_fontFileLoader);
+    g_fontFileLoaderRegistered = false;
+}
+
+// TextFormat과 같은 폰트의 FontFace를 찾아 온디맨드 글리프 폰트를 만듭니다.
+// 폰트를 못 찾으면 nullptr (g.text는 DrawText로 그립니다)
+static std::unique_ptr<GlyphFont> CreateGlyphFont(IDWriteTextFormat* pFormat) {
+    if (!pFormat) return nullptr;
+
+    IDWriteFontCollection* pCollection = nullptr;
+    pFormat->GetFontCollection(&pCollection);
+    if (!pCollection) g_pDWriteFactory->GetSystemFontCollection(&pCollection);
+    if (!pCollection) return nullptr;
+
+    WCHAR familyName[256] = {};
+    pFormat->GetFontFamilyName(familyName, 256);
+
+    UINT32 index = 0;
+    BOOL exists = FALSE;
+    pCollection->FindFamilyName(familyName, &index, &exists);
+
+    IDWriteFontFamily* pFamily = nullptr;
+    IDWriteFont* pFont = nullptr;
+    IDWriteFontFace* pRawFace = nullptr;
+    if (exists && SUCCEEDED(pCollection->GetFontFamily(index, &pFamily))) {
+        if (SUCCEEDED(pFamily->GetFirstMatchingFont(
+            pFormat->GetFontWeight(), pFormat->GetFontStretch(), pFormat->GetFontStyle(), &pFont))) {
+            pFont->CreateFontFace(&pRawFace);
+        }
+    }
+    SafeRelease(&pFont);
+    SafeRelease(&pFamily);
+    SafeRelease(&pCollection);
+    if (!pRawFace) {
+        printf("[Resource Warning] Font family '%ls' not found, glyph cache skipped (falls back to DrawText)\n", familyName);
+        return nullptr;
+    }
+
+    // 래스터라이저/커닝 람다가 같이 들고 다니도록 shared_ptr로 감쌉니다.
+    std::shared_ptr<IDWriteFontFace> face(pRawFace, [](IDWriteFontFace* p) { p->Release(); });
+    std::shared_ptr<IDWriteFontFace1> face1;
+    IDWriteFontFace1* pRawFace1 = nullptr;
+    if (SUCCEEDED(pRawFace->QueryInterface(__uuidof(IDWriteFontFace1), (void**)&pRawFace1))) {
+        if (pRawFace1->HasKerningPairs())
+            face1.reset(pRawFace1, [](IDWriteFontFace1* p) { p->Release(); });
+        else
+            pRawFace1->Release();
+    }
+
+    DWRITE_FONT_METRICS fm;
+    face->GetMetrics(&fm);
+    const float emSize = pFormat->GetFontSize();
+    const float scale = emSize / fm.designUnitsPerEm;
+    const float ascent = fm.ascent * scale;
+    const float lineHeight = (fm.ascent + fm.descent + fm.lineGap) * scale;
+
+    auto rasterize = [face, emSize, scale](uint32_t cp, GlyphBitmap& out) -> bool {
+        UINT16 glyph = 0;
+        UINT32 cp32 = cp;
+        if (FAILED(face->GetGlyphIndices(&cp32, 1, &glyph))) return false;
+        if (glyph == 0 && cp != ' ') return false; // 폰트에 없는 글자
+
+        DWRITE_GLYPH_METRICS gm;
+        face->GetDesignGlyphMetrics(&glyph, 1, &gm);
+        out.advance = gm.advanceWidth * scale;
+
+        FLOAT advance = 0.0f;
+        DWRITE_GLYPH_OFFSET offset = {};
+        DWRITE_GLYPH_RUN run = {};
+        run.fontFace = face.get();
+        run.fontEmSize = emSize;
+        run.glyphCount = 1;
+        run.glyphIndices = &glyph;
+        run.glyphAdvances = &advance;
+        run.glyphOffsets = &offset;
+
+        IDWriteGlyphRunAnalysis* pAnalysis = nullptr;
+        if (FAILED(g_pDWriteFactory->CreateGlyphRunAnalysis(&run, 1.0f, nullptr,
+            DWRITE_RENDERING_MODE_NATURAL, DWRITE_MEASURING_MODE_NATURAL, 0.0f, 0.0f, &pAnalysis)))
+            return false;
+
+        RECT rc = {};
+        pAnalysis->GetAlphaTextureBounds(DWRITE_TEXTURE_CLEARTYPE_3x1, &rc);
+        out.width = rc.right - rc.left;
+        out.height = rc.bottom - rc.top;
+        out.offsetX = (float)rc.left;
+        out.offsetY = (float)rc.top;
+
+        if (out.width > 0 && out.height > 0) {
+            // ClearType 3x1 커버리지를 평균 내서 8비트 알파로 만듭니다.
+            std::vector<BYTE> rgb((size_t)out.width * out.height * 3);
+            pAnalysis->CreateAlphaTexture(DWRITE_TEXTURE_CLEARTYPE_3x1, &rc, rgb.data(), (UINT32)rgb.size());
+            out.alpha.resize((size_t)out.width * out.height);
+            for (size_t i = 0; i < out.alpha.size(); i++) {
+                out.alpha[i] = (uint8_t)((rgb[i * 3] + rgb[i * 3 + 1] + rgb[i * 3 + 2]) / 3);
+            }
+        }
+        pAnalysis->Release();
+        return true;
+        };
+
+    GlyphFont::Kerning kerning;
+    if (face1) {
+        kerning = [face1, scale](uint32_t left, uint32_t right) -> float {
+            UINT32 cps[2] = { left, right };
+            UINT16 glyphs[2] = {};
+            INT32 adjust[2] = {};
+            face1->GetGlyphIndices(cps, 2, glyphs);
+            face1->GetKerningPairAdjustments(2, glyphs, adjust);
+            return adjust[0] * scale;
+            };
+    }
+
+    return std::make_unique<GlyphFont>(&g_glyphAtlas, rasterize, kerning, lineHeight, ascent);
+}
+
+// AngelCode BMFont 텍스트 포맷(.fnt) 로더
+static std::unique_ptr<GlyphFont> LoadBitmapFont(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        printf("[Resource Error] Failed to open bitmap font: %s\n", path.c_str());
+        return nullptr;
+    }
+
+    // 페이지 이미지 경로는 .fnt 파일 기준 상대 경로
+    std::string dir;
+    size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) dir = path.substr(0, slash + 1);
+
+    // "key=value key="quoted value"" 형식의 한 줄을 파싱
+    auto parseLine = [](const std::string& line, std::string& tag) {
+        std::map<std::string, std::string> kv;
+        size_t i = line.find(' ');
+        tag = line.substr(0, i);
+        while (i != std::string::npos && i < line.size()) {
+            size_t keyStart = line.find_first_not_of(' ', i);
+            if (keyStart == std::string::npos) break;
+            size_t eq = line.find('=', keyStart);
+            if (eq == std::string::npos) break;
+            std::string key = line.substr(keyStart, eq - keyStart);
+            size_t valStart = eq + 1;
+            if (valStart < line.size() && line[valStart] == '"') {
+                size_t valEnd = line.find('"', valStart + 1);
+                kv[key] = line.substr(valStart + 1, valEnd - valStart - 1);
+                i = valEnd == std::string::npos ? valEnd : valEnd + 1;
+            }
+            else {
+                i = line.find(' ', valStart);
+                kv[key] = line.substr(valStart, i - valStart);
+            }
+        }
+        return kv;
+        };
+    auto num = [](std::map<std::string, std::string>& kv, const char* key) {
+        auto it = kv.find(key);
+        return it == kv.end() ? 0 : atoi(it->second.c_str());
+        };
+
+    std::unique_ptr<GlyphFont> font;
+    std::map<int, int> pages; // BMFont 페이지 번호 -> g_bitmapTable 인덱스
+    std::string line, tag;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        auto kv = parseLine(line, tag);
+
+        if (tag == "common") {
+            font = std::make_unique<GlyphFont>((float)num(kv, "lineHeight"), 0.0f);
+        }
+        else if (tag == "page") {
+            int id = LoadImageCached(dir + kv["file"]);
+            if (id < 0) return nullptr;
+            pages[num(kv, "id")] = id;
+        }
+        else if (tag == "char" && font) {
+            GlyphInfo info;
+            info.x = num(kv, "x");
+            info.y = num(kv, "y");
+            info.w = num(kv, "width");
+            info.h = num(kv, "height");
+            info.offsetX = (float)num(kv, "xoffset");
+            info.offsetY = (float)num(kv, "yoffset");
+            info.advance = (float)num(kv, "xadvance");
+            // 모르는 페이지를 공유 아틀라스(-1)로 그리면 엉뚱한 글리프가 나오므로 그 글자는 건너뜀
+            int pageId = num(kv, "page");
+            auto page = pages.find(pageId);
+            if (page == pages.end()) {
+                printf("[Resource Error] char %d references unknown page %d: %s\n", num(kv, "id"), pageId, path.c_str());
+                continue;
+            }
+            info.page = page->second;
+            font->AddGlyph((uint32_t)num(kv, "id"), info);
+        }
+        else if (tag == "kerning" && font) {
+            font->AddKerning((uint32_t)num(kv, "first"), (uint32_t)num(kv, "second"), (float)num(kv, "amount"));
+        }
+    }
+
+    if (!font) printf("[Resource Error] Invalid bitmap font (no 'common' line): %s\n", path.c_str());
+    return font;
+}
+
+// Aseprite / TexturePacker JSON (frames가 배열 또는 해시) -> SpriteSheet
+// 해시 형식은 파일 순서가 곧 프레임 번호라서 ordered_json으로 읽습니다.
+static std::unique_ptr<SpriteSheet> LoadSpriteSheet(const std::string& imagePath, const std::string& jsonPath) {
+    using ojson = nlohmann::ordered_json;
+
+    std::ifstream file(jsonPath);
+    if (!file.is_open()) {
+        printf("[Resource Error] Failed to open sprite sheet: %s\n", jsonPath.c_str());
+        return nullptr;
+    }
+    ojson j;
+    try {
+        file >> j;
+    }
+    catch (const json::parse_error& e) {
+        printf("[JSON Error] Parse error in %s: %s\n", jsonPath.c_str(), e.what());
+        return nullptr;
+    }
+    if (!j.is_object()) return nullptr;
+
+    // json.value()는 키가 있는데 타입이 다르면 type_error를 던지므로 타입을 확인하고 꺼냅니다.
+    auto num = [](const ojson& o, const char* key, float def) {
+        auto it = o.find(key);
+        return (it != o.end() && it->is_number()) ? it->get<float>() : def;
+        };
+    auto str = [](const ojson& o, const char* key, const std::string& def) {
+        auto it = o.find(key);
+        return (it != o.end() && it->is_string()) ? it->get<std::string>() : def;
+        };
+    auto flag = [](const ojson& o, const char* key) {
+        auto it = o.find(key);
+        return it != o.end() && it->is_boolean() && it->get<bool>();
+        };
+
+    auto sheet = std::make_unique<SpriteSheet>();
+    bool warnedRotated = false;
+    auto addFrame = [&](const std::string& name, const ojson& f) {
+        if (!f.is_object()) return;
+        auto rect = f.find("frame");
+        if (rect == f.end() || !rect->is_object()) return;
+
+        SpriteFrame frame;
+        frame.sx = num(*rect, "x", 0.0f);
+        frame.sy = num(*rect, "y", 0.0f);
+        frame.sw = num(*rect, "w", 0.0f);
+        frame.sh = num(*rect, "h", 0.0f);
+
+        // 트리밍된 프레임은 원래 크기 안의 위치를 기억해서 그릴 때 보정
+        auto trim = f.find("spriteSourceSize");
+        if (trim != f.end() && trim->is_object()) {
+            frame.ox = num(*trim, "x", 0.0f);
+            frame.oy = num(*trim, "y", 0.0f);
+        }
+        frame.w = frame.sw;
+        frame.h = frame.sh;
+        auto source = f.find("sourceSize");
+        if (source != f.end() && source->is_object()) {
+            frame.w = num(*source, "w", frame.sw);
+            frame.h = num(*source, "h", frame.sh);
+        }
+        // TexturePacker는 duration이 없음. 0ms 프레임은 무한 루프가 되므로 최소 1ms
+        frame.durationMs = (std::max)(1.0f, num(f, "duration", 100.0f));
+
+        if (flag(f, "rotated") && !warnedRotated) {
+            printf("[Resource Warning] Rotated frames are not supported, export without rotation: %s\n", jsonPath.c_str());
+            warnedRotated = true;
+        }
+
+        if (!name.empty()) sheet->frameNames[name] = (int)sheet->frames.size();
+        sheet->frames.push_back(frame);
+        };
+
+    auto frames = j.find("frames");
+    if (frames != j.end() && frames->is_array()) {
+        for (const auto& f : *frames) {
+            addFrame(f.is_object() ? str(f, "filename", "") : std::string(), f);
+        }
+    }
+    else if (frames != j.end() && frames->is_object()) {
+        for (const auto& item : frames->items()) addFrame(item.key(), item.value());
+    }
+    if (sheet->frames.empty()) {
+        printf("[Resource Error] Sprite sheet has no frames: %s\n", jsonPath.c_str());
+        return nullptr;
+    }
+
+    // Aseprite 태그 (meta.frameTags)
+    const ojson empty;
+    const ojson& meta = j.contains("meta") ? j["meta"] : empty;
+    if (meta.is_object() && meta.contains("frameTags") && meta["frameTags"].is_array()) {
+        for (const auto& t : meta["frameTags"]) {
+            if (!t.is_object()) continue;
+            AnimTag tag;
+            tag.name = str(t, "name", "");
+            tag.from = (int)num(t, "from", 0.0f);
+            tag.to = (int)num(t, "to", 0.0f);
+            if (tag.from < 0 || tag.to >= (int)sheet->frames.size() || tag.from > tag.to) continue;
+
+            std::string dir = str(t, "direction", "forward");
+            if (dir == "reverse") tag.direction = AnimDirection::Reverse;
+            else if (dir == "pingpong") tag.direction = AnimDirection::PingPong;
+            else if (dir == "pingpong_reverse") tag.direction = AnimDirection::PingPongReverse;
+
+            // Aseprite는 repeat을 문자열로 내보냅니다.
+            auto repeat = t.find("repeat");
+            if (repeat != t.end() && repeat->is_string()) tag.repeat = atoi(repeat->get<std::string>().c_str());
+            else if (repeat != t.end() && repeat->is_number()) tag.repeat = repeat->get<int>();
+            sheet->tags.push_back(std::move(tag));
+        }
+    }
+
+    // 이미지 경로를 비워 두면 meta.image를 json 기준 상대 경로로 사용
+    std::string image = imagePath;
+    if (image.empty() && meta.is_object()) {
+        size_t slash = jsonPath.find_last_of("/\\");
+        std::string dir = slash == std::string::npos ? "" : jsonPath.substr(0, slash + 1);
+        image = dir + str(meta, "image", "");
+    }
+    sheet->imageId = LoadImageCached(image);
+    if (sheet->imageId < 0) printf("[Resource Error] Failed to load sprite sheet image: %s\n", image.c_str());
+    return sheet;
+}
+
 sol::object wrap_json_node(nlohmann::json& j, sol::state_view lua) {
     if (j.is_structured()) {
         return sol::make_object<JsonNode>(lua, JsonNode{ &j });
@@ -94,6 +531,7 @@ sol::object wrap_json_node(nlohmann::json& j, sol::state_view lua) {
 struct JsonTask : public ITask {
     std::string path;
     std::future<nlohmann::json> fuel;
+    std::future<void> worker;
     sol::object result = sol::nil;
 
     bool check(sol::this_state s) override {
@@ -152,6 +590,7 @@ void register_res(sol::state& lua, const char* name) {
     lua.new_usertype<ITask>("Task",
         "check", &ITask::check,
         "getResult", &ITask::getResult,
+        "await", &ITask_await,
         "isDone", sol::readonly(&ITask::isDone)
     );
     register_json_type(lua);
@@ -160,18 +599,7 @@ void register_res(sol::state& lua, const char* name) {
 
     // 1. 이미지 로드 (캐싱 로직 포함)
     res["image"] = [](std::string path) -> int {
-        auto it = g_pathCache.find(path);
-        if (it != g_pathCache.end())
-            return it->second;
-
-        ID2D1Bitmap* pBitmap = LoadBitmapFromFile(g_pDCRT, path);
-        if (!pBitmap)
-            return -1;
-
-        int newID = (int)g_bitmapTable.size();
-        g_bitmapTable.push_back(pBitmap);
-        g_pathCache[path] = newID;
-        return newID;
+        return LoadImageCached(path);
         };
 
 
@@ -191,6 +619,7 @@ void register_res(sol::state& lua, const char* name) {
 
         int id = (int)g_fontTable.size();
         g_fontTable.push_back(pTextFormat);
+        g_glyphFontTable.push_back(CreateGlyphFont(pTextFormat));
         return id;
         };
 
@@ -212,16 +641,20 @@ void register_res(sol::state& lua, const char* name) {
 
         g_fontFamilyTable.push_back(wPath);
 
-        // 3. TextFormat 생성
+        // 3. TextFormat 생성 (파일 하나짜리 컬렉션을 써야 DirectWrite와 글리프 캐시가 이 폰트를 찾음)
+        IDWriteFontCollection* pCollection = CreateFontFileCollection(wPath);
+        if (!pCollection)
+            printf("[Resource Warning] Font collection for %s failed, looking up '%s' in system fonts\n", path.c_str(), familyName.c_str());
         IDWriteTextFormat* pTextFormat = nullptr;
         HRESULT hr = g_pDWriteFactory->CreateTextFormat(
             wName.c_str(),
-            nullptr,
+            pCollection,
             DWRITE_FONT_WEIGHT_NORMAL,
             DWRITE_FONT_STYLE_NORMAL,
             DWRITE_FONT_STRETCH_NORMAL,
             size, L"ko-kr", &pTextFormat
         );
+        SafeRelease(&pCollection); // TextFormat이 참조를 들고 있음
 
         if (FAILED(hr)) {
             printf("[Resource Error] Failed to create TextFormat for: %s (HRESULT: 0x%08X)\n", familyName.c_str(), hr);
@@ -232,10 +665,64 @@ void register_res(sol::state& lua, const char* name) {
 
         int id = (int)g_fontTable.size();
         g_fontTable.push_back(pTextFormat);
+        g_glyphFontTable.push_back(CreateGlyphFont(pTextFormat));
+
+        return id;
+        };
+
+    // 3-1. BMFont(.fnt) 로드: g_fontTable 자리는 nullptr로 두고 글리프 폰트만 씁니다.
+    res["bitmapFont"] = [](std::string path) -> int {
+        auto font = LoadBitmapFont(path);
+        if (!font) return -1;
 
+        int id = (int)g_fontTable.size();
+        g_fontTable.push_back(nullptr);
+        g_glyphFontTable.push_back(std::move(font));
         return id;
         };
 
+    // 3-2. 스프라이트 시트 (Aseprite/TexturePacker JSON). g.newAnim, g.sprite에 넘기는 id를 돌려줍니다.
+    res["spritesheet"] = [](std::string imagePath, std::string jsonPath) -> int {
+        // 같은 json을 다른 이미지와 쓸 수 있으므로 둘 다 키에 넣음
+        const std::string key = imagePath + '\n' + jsonPath;
+        auto it = g_spriteSheetCache.find(key);
+        if (it != g_spriteSheetCache.end()) return it->second;
+
+        auto sheet = LoadSpriteSheet(imagePath, jsonPath);
+        if (!sheet) return -1;
+
+        int id = (int)g_spriteSheets.size();
+        g_spriteSheets.push_back(std::move(sheet));
+        g_spriteSheetCache[key] = id;
+        return id;
+        };
+
+    // 3-3. 리소스 메모리 통계 (픽셀 바이트는 BGRA 기준 추정치)
+    res["stats"] = [](sol::this_state s) {
+        sol::state_view lua(s);
+        // 캔버스 크기는 DIP라 DPI에 따라 실제 픽셀 수와 다르므로, 둘 다 비트맵의 픽셀 크기로 셉니다.
+        size_t totalBytes = 0;
+        for (auto* bmp : g_bitmapTable) {
+            if (!bmp) continue;
+            auto size = bmp->GetPixelSize();
+            totalBytes += (size_t)size.width * size.height * 4;
+        }
+        const size_t canvasBytes = g_canvases.Bytes();
+        size_t atlasBytes = (size_t)g_glyphAtlas.Width() * g_glyphAtlas.Height();
+        if (g_pGlyphAtlasBitmap) atlasBytes *= 5; // CPU 알파 + GPU BGRA
+
+        sol::table t = lua.create_table();
+        t["images"] = g_pathCache.size();
+        t["imageBytes"] = totalBytes - canvasBytes;
+        t["canvases"] = g_canvases.Count();
+        t["canvasBytes"] = canvasBytes;
+        t["fonts"] = g_fontTable.size();
+        t["glyphAtlasBytes"] = atlasBytes;
+        t["spriteSheets"] = g_spriteSheets.size();
+        t["anims"] = g_animPool.Count();
+        return t;
+        };
+
     // 4. 드디어 대망의 JSON 로더 (여기에 꽂으시면 됩니다)
     res["json"] = [&lua](std::string path) -> sol::object {
         std::ifstream file(path);
@@ -261,7 +748,12 @@ void register_res(sol::state& lua, const char* name) {
         auto task = std::make_shared<JsonTask>();
         task->path = path; // 캐시 키로 사용
 
-        task->fuel = std::async(std::launch::async, [path]() {
+        // 결과를 먼저 채운 뒤 완료를 통지해야 await 쪽 check()가 바로 성공합니다.
+        auto promise = std::make_shared<std::promise<nlohmann::json>>();
+        task->fuel = promise->get_future();
+        std::weak_ptr<ITask> weak = task;
+
+        task->worker = std::async(std::launch::async, [path, promise, weak]() {
             std::ifstream file(path);
             nlohmann::json j;
             if (file.is_open()) {
@@ -272,9 +764,14 @@ void register_res(sol::state& lua, const char* name) {
                     // 파싱 에러 처리 로직 (빈 객체 반환 등)
                 }
             }
-            return j;
+            promise->set_value(std::move(j));
+            NotifyTaskReady(weak);
             });
 
         return task;
         };
+
+    // 5. 격자 길찾기: res.navGrid(w, h, cells) 또는 res.navGrid(layer, { blocked = { ... } })
+    // grid:find / grid:findAsync(sx, sy, tx, ty), grid:flowField / grid:flowFieldAsync(tx, ty)
+    register_nav(lua, res);
 }
\ No newline at end of file
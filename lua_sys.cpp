@@ -1,6 +1,21 @@
 ﻿#include "lua_engine.h"
+#include <algorithm>
 #include <tuple>
 
+GcSchedule g_gcSchedule;
+HitchWatchdog g_watchdog;
+
+// 히치 보고서에 붙는 한 줄 (워치독 훅 안, 메인 스레드에서 호출)
+static std::string DescribeHitch(lua_State* L) {
+    const GcSchedule& gc = g_gcSchedule;
+    const LuaPoolAllocator* pool = PoolAllocatorOf(L);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "gc=%dKB mode=%s lastGcMs=%.2f cycles=%llu frameAllocs=%llu coroutines=%zu awaiting=%zu",
+        lua_gc(L, LUA_GCCOUNT), GcModeName(gc), gc.lastFrameMs, (unsigned long long)gc.cycles,
+        (unsigned long long)(pool ? pool->Stats().frameAllocs : 0), AsyncCoroutineCount(), AsyncAwaitingCount());
+    return buf;
+}
+
 void register_sys(sol::state& lua, const char* name) {
     auto s = lua.create_named_table(name);
 
@@ -62,7 +77,84 @@ void register_sys(sol::state& lua, const char* name) {
         SetCursor(hCursor);
         };
 
-    // 7. 엔진 종료
+    // 7. Lua 메모리 통계 (풀 할당기 기준, 프레임 값은 직전 프레임)
+    s["memory"] = [](sol::this_state ts) -> sol::object {
+        sol::state_view lua(ts);
+        const LuaPoolAllocator* pool = PoolAllocatorOf(ts);
+        if (!pool) return sol::lua_nil;
+        const LuaAllocStats& st = pool->Stats();
+
+        sol::table t = lua.create_table();
+        t["live"] = st.liveBytes;
+        t["peak"] = st.peakBytes;
+        t["reserved"] = st.reservedBytes;
+        t["allocs"] = st.totalAllocs;
+        t["frameAllocs"] = st.frameAllocs;
+        t["frameBytes"] = st.frameBytes;
+        return t;
+        };
+
+    // 8. GC 스케줄링: sys.gc{ mode = "incremental" | "generational" | "auto", budgetMs = 2 }
+    // 인자 없이 부르면 통계만 돌려줍니다. 모르는 모드는 Lua 오류입니다.
+    // (luaL_error가 longjmp로 빠져나가도 되도록 인자는 레지스트리 참조 없는 stack_table로 받음)
+    s["gc"] = [](sol::optional<sol::stack_table> opts, sol::this_state ts) {
+        sol::state_view lua(ts);
+        lua_State* L = ts;
+        GcSchedule& gc = g_gcSchedule;
+
+        if (opts) {
+            sol::stack_table o = *opts;
+            std::string_view mode = o.get_or<std::string_view>("mode", GcModeName(gc));
+            if (!SetGcMode(L, gc, mode))
+                luaL_error(L, "sys.gc: unknown mode '%s' (incremental, generational, auto)", mode.data());
+            gc.budgetMs = (std::max)(o.get_or("budgetMs", gc.budgetMs), 0.0);
+        }
+
+        sol::table t = lua.create_table();
+        t["mode"] = GcModeName(gc);
+        t["budgetMs"] = gc.budgetMs;
+        t["lastMs"] = gc.lastFrameMs;
+        t["overBudgetFrames"] = gc.overBudgetFrames;
+        t["cycles"] = gc.cycles;
+        t["heapKB"] = lua_gc(L, LUA_GCCOUNT);
+        return t;
+        };
+
+    // 9. 코루틴 스케줄러: sys.async(fn), sys.sleep(ms), sys.nextFrame()
+    register_async(s);
+
+    // 10. 트윈: sys.tween(target, ms, { x = 100 }, { ease = "quadOut", delay = 0, onComplete = fn })
+    register_tween(lua, s);
+
+    // 11. 프레임 히치 감시: sys.watchdog{ budgetMs = 100, file = "hitch.log", maxBytes = 262144, keep = 3 }
+    // Update/Draw/입력 핸들러가 budgetMs를 넘기면 Lua 스택과 GC 상태를 파일에 남깁니다.
+    // false를 넘기면 끄고, 인자 없이 부르면 상태만 돌려줍니다.
+    s["watchdog"] = [](sol::object opts, sol::this_state ts) {
+        sol::state_view lua(ts);
+
+        if (opts.is<bool>() && !opts.as<bool>()) {
+            g_watchdog.Stop();
+        }
+        else if (opts.is<sol::table>()) {
+            sol::table o = opts.as<sol::table>();
+            HitchWatchdog::Config cfg = g_watchdog.GetConfig();
+            cfg.budgetMs = (std::max)(o.get_or("budgetMs", cfg.budgetMs), 1.0);
+            cfg.file = o.get_or("file", cfg.file);
+            cfg.maxFileBytes = o.get_or("maxBytes", cfg.maxFileBytes);
+            cfg.keepFiles = (std::max)(o.get_or("keep", cfg.keepFiles), 1);
+            // 훅은 메인 상태에 걸고, 이후에 만든 코루틴이 물려받습니다.
+            g_watchdog.Start(::lua.lua_state(), cfg, &DescribeHitch);
+        }
+
+        sol::table t = lua.create_table();
+        t["enabled"] = g_watchdog.Enabled();
+        t["budgetMs"] = g_watchdog.GetConfig().budgetMs;
+        t["file"] = g_watchdog.GetConfig().file;
+        t["hitches"] = g_watchdog.HitchCount();
+        return t;
+        };
+
+    // 12. 엔진 종료
     s["quit"] = []() {
         PostQuitMessage(0);
         };
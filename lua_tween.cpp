@@ -0,0 +1,223 @@
+#include "lua_engine.h"
+#include "particles.h"
+#include "tween.h"
+
+// sys.tween: 네이티브 트윈 풀 (tween.h)
+// 시작 값 읽기, 결과 쓰기, 완료 콜백 호출을 TickTweens 한 곳에서 프레임당 한 번씩 처리합니다.
+// 타깃은 Lua 테이블 필드, 파티클 에미터 필드, 애니메이션 속도(anim.speed)입니다.
+
+struct TweenTarget {
+    enum class Kind : uint8_t { None, TableField, Emitter, AnimSpeed };
+    Kind kind = Kind::None;
+
+    sol::table table;                        // TableField
+    std::string key;
+    std::weak_ptr<ParticleEmitter> emitter;  // Emitter (트윈이 에미터를 붙잡아 두지 않음)
+    float ParticleEmitter::* field = nullptr;
+    AnimHandle anim;                         // AnimSpeed
+};
+
+// sys.tween이 돌려주는 핸들 (트윈 자체는 끝나면 풀에서 알아서 정리됨)
+struct Tween {
+    TweenGroupHandle handle;
+};
+
+static TweenPool g_tweens;
+static std::vector<TweenTarget> g_tweenTargets;
+static std::vector<uint32_t> g_freeTweenTargets;
+static std::vector<sol::protected_function> g_tweenCallbacks; // 그룹 슬롯별 onComplete
+
+static uint32_t AllocTweenTarget(TweenTarget&& t) {
+    if (!g_freeTweenTargets.empty()) {
+        uint32_t index = g_freeTweenTargets.back();
+        g_freeTweenTargets.pop_back();
+        g_tweenTargets[index] = std::move(t);
+        return index;
+    }
+    g_tweenTargets.push_back(std::move(t));
+    return (uint32_t)g_tweenTargets.size() - 1;
+}
+
+static float ParticleEmitter::* EmitterField(std::string_view key) {
+    static const std::pair<std::string_view, float ParticleEmitter::*> kFields[] = {
+        { "x", &ParticleEmitter::x }, { "y", &ParticleEmitter::y },
+        { "rate", &ParticleEmitter::rate }, { "drag", &ParticleEmitter::drag },
+        { "gravityX", &ParticleEmitter::gravityX }, { "gravityY", &ParticleEmitter::gravityY },
+        { "direction", &ParticleEmitter::direction }, { "spread", &ParticleEmitter::spread },
+        { "sizeStart", &ParticleEmitter::sizeStart }, { "sizeEnd", &ParticleEmitter::sizeEnd },
+    };
+    for (const auto& [name, field] : kFields) {
+        if (name == key) return field;
+    }
+    return nullptr;
+}
+
+static float ReadTweenTarget(TweenTarget& t) {
+    switch (t.kind) {
+    case TweenTarget::Kind::TableField:
+        return t.table.get_or(t.key, 0.0f);
+    case TweenTarget::Kind::Emitter:
+        if (auto e = t.emitter.lock()) return (*e).*t.field;
+        return 0.0f;
+    case TweenTarget::Kind::AnimSpeed:
+        if (AnimState* st = g_animPool.Get(t.anim)) return st->speed;
+        return 0.0f;
+    default:
+        return 0.0f;
+    }
+}
+
+static void WriteTweenTarget(TweenTarget& t, float v) {
+    switch (t.kind) {
+    case TweenTarget::Kind::TableField:
+        t.table[t.key] = v;
+        break;
+    case TweenTarget::Kind::Emitter:
+        if (auto e = t.emitter.lock()) (*e).*t.field = v;
+        break;
+    case TweenTarget::Kind::AnimSpeed:
+        if (AnimState* st = g_animPool.Get(t.anim)) st->speed = (std::max)(0.0f, v);
+        break;
+    default:
+        break;
+    }
+}
+
+// props의 필드마다 트윈 하나씩, 한 그룹으로 묶어서 만듭니다.
+static Tween CreateTween(sol::object target, float durationMs, sol::optional<sol::table> props,
+    sol::optional<sol::table> opts, const TweenGroupHandle* after) {
+    Ease ease = Ease::Linear;
+    float delayMs = 0.0f;
+    sol::protected_function onComplete;
+    if (opts) {
+        sol::table o = *opts;
+        std::string easeName = o.get_or<std::string>("ease", "linear");
+        if (!ParseEase(easeName, ease)) printf("[Tween] Unknown ease '%s', using linear\n", easeName.c_str());
+        delayMs = o.get_or("delay", 0.0f);
+        sol::object cb = o["onComplete"];
+        if (cb.get_type() == sol::type::function) onComplete = cb.as<sol::protected_function>();
+    }
+
+    Tween tween{ g_tweens.CreateGroup(durationMs, delayMs, ease, after) };
+    if (g_tweenCallbacks.size() <= tween.handle.slot) g_tweenCallbacks.resize(tween.handle.slot + 1);
+    g_tweenCallbacks[tween.handle.slot] = std::move(onComplete);
+    if (!props) return tween;
+
+    // 타깃 종류는 한 번만 판별
+    TweenTarget base;
+    if (target.is<ParticleEmitter>()) {
+        base.kind = TweenTarget::Kind::Emitter;
+        base.emitter = target.as<std::shared_ptr<ParticleEmitter>>();
+    }
+    else if (target.is<Anim>()) {
+        base.kind = TweenTarget::Kind::AnimSpeed;
+        base.anim = target.as<Anim&>().handle;
+    }
+    else if (target.get_type() == sol::type::table) {
+        base.kind = TweenTarget::Kind::TableField;
+        base.table = target.as<sol::table>();
+    }
+    else {
+        printf("[Tween] Unsupported tween target\n");
+        return tween;
+    }
+
+    for (const auto& [k, v] : *props) {
+        if (k.get_type() != sol::type::string || v.get_type() != sol::type::number) continue;
+        std::string key = k.as<std::string>();
+
+        TweenTarget t = base;
+        if (t.kind == TweenTarget::Kind::Emitter) {
+            t.field = EmitterField(key);
+            if (!t.field) {
+                printf("[Tween] ParticleEmitter has no tweenable field '%s'\n", key.c_str());
+                continue;
+            }
+        }
+        else if (t.kind == TweenTarget::Kind::AnimSpeed && key != "speed") {
+            printf("[Tween] Anim can only tween 'speed' (got '%s')\n", key.c_str());
+            continue;
+        }
+        else {
+            t.key = std::move(key);
+        }
+        g_tweens.AddTween(tween.handle, v.as<float>(), AllocTweenTarget(std::move(t)));
+    }
+    return tween;
+}
+
+void TickTweens(double dtms) {
+    if (g_tweens.GroupCount() == 0) return;
+
+    // 1. 시간 진행, 이번 프레임에 시작한 트윈은 현재 값을 시작 값으로
+    g_tweens.Advance((float)dtms);
+    for (uint32_t i : g_tweens.Started())
+        g_tweens.SetFrom(i, ReadTweenTarget(g_tweenTargets[g_tweens.Target(i)]));
+
+    // 2. 이징 계산 후 타깃에 한 번에 쓰기
+    g_tweens.Evaluate();
+    for (uint32_t i : g_tweens.Active())
+        WriteTweenTarget(g_tweenTargets[g_tweens.Target(i)], g_tweens.Value(i));
+
+    // 3. 끝난 트윈 정리
+    static std::vector<uint32_t> finished, cancelled, freed;
+    finished.clear();
+    cancelled.clear();
+    freed.clear();
+    g_tweens.Collect(finished, cancelled, freed);
+    for (uint32_t t : freed) {
+        g_tweenTargets[t] = TweenTarget();
+        g_freeTweenTargets.push_back(t);
+    }
+    for (uint32_t s : cancelled) g_tweenCallbacks[s] = sol::protected_function();
+    if (finished.empty()) return;
+
+    // 4. 완료 콜백은 먼저 모두 꺼낸 뒤 한 번에 호출 (콜백 안에서 새 트윈을 만들어도 안전)
+    std::vector<sol::protected_function> callbacks;
+    for (uint32_t s : finished) {
+        if (g_tweenCallbacks[s].valid()) callbacks.push_back(std::move(g_tweenCallbacks[s]));
+        g_tweenCallbacks[s] = sol::protected_function();
+    }
+    for (auto& cb : callbacks) {
+        auto result = cb();
+        if (!result.valid()) {
+            sol::error err = result;
+            printf("[LUA ERROR] tween onComplete: %s\n", err.what());
+        }
+    }
+}
+
+void ResetTweens() {
+    // 테이블/콜백 참조를 상태가 닫히기 전에 풀어야 합니다.
+    g_tweens.Clear();
+    g_tweenTargets.clear();
+    g_freeTweenTargets.clear();
+    g_tweenCallbacks.clear();
+}
+
+void register_tween(sol::state& lua, sol::table& sys) {
+    lua.new_usertype<Tween>("Tween",
+        sol::no_constructor,
+        "active", sol::property([](Tween& t) { return g_tweens.IsAlive(t.handle); }),
+        // tw:after(target, ms, props, opts): tw가 끝나면 시작 (시작 값은 그때의 현재 값)
+        "after", [](Tween& t, sol::object target, float durationMs,
+            sol::optional<sol::table> props, sol::optional<sol::table> opts) {
+                return CreateTween(target, durationMs, props, opts, &t.handle);
+        },
+        // 뒤에 이어진 트윈도 함께 취소, onComplete는 불리지 않습니다.
+        "cancel", [](Tween& t) { return g_tweens.Cancel(t.handle); }
+    );
+
+    sys["tween"] = [](sol::object target, float durationMs,
+        sol::optional<sol::table> props, sol::optional<sol::table> opts) {
+            return CreateTween(target, durationMs, props, opts, nullptr);
+        };
+
+    sys["tweenStats"] = [](sol::this_state s) {
+        sol::state_view lua(s);
+        sol::table t = lua.create_table();
+        t["groups"] = g_tweens.GroupCount();
+        t["tweens"] = g_tweens.TweenCount();
+        return t;
+        };
+}
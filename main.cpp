@@ -1,5 +1,7 @@
 #include "lua_engine.h"
 
+std::unique_ptr<LuaPoolAllocator> g_luaAllocator; // 현재 lua 상태의 풀. lua보다 먼저 선언해서 더 늦게 소멸되도록
+AnimPool g_animPool;              // Anim 유저데이터가 lua와 함께 닫힐 때 슬롯을 반환하므로 마찬가지
 sol::state lua;
 ULONGLONG lastTick = 0;
 int gDrawW = 0, gDrawH = 0;
@@ -20,6 +22,7 @@ std::string entryFile = "main.lua";
 static std::string g_last_lua_error = "";
 #define CALL_LUA_FUNC(lua_state, func_name, ...) \
     { \
+        HitchPhase hitchPhase(g_watchdog, func_name); \
         sol::protected_function f = lua_state[func_name]; \
         if (f.valid()) { \
             auto result = f(__VA_ARGS__); \
@@ -45,12 +48,24 @@ std::string to_string(const std::wstring& wstr) {
 
 std::vector<std::string> g_frameLogBuffer;
 void InitLuaEngine(const char* main) {
-    g_stateStack.clear();
-    g_clipCount = 0;
+    double startMs = GetTimeMs();
+    // 소스 읽기/해시는 상태를 만드는 동안 워커 스레드에서 미리 진행
+    PrefetchLuaSources(main);
+    g_watchdog.Stop(); // 훅이 닫힐 상태를 가리키지 않도록 (스크립트가 다시 켜야 함)
+    ResetAsyncScheduler(); // 이전 상태의 코루틴은 상태가 닫히기 전에 정리
+    ResetHitIndex();
+    ResetTweens();
+    StopNavWorkers(); // 이전 상태의 길찾기 요청은 버림
+
+    g_draw = DrawState();
     g_frameLogBuffer.clear();
     g_last_lua_error = "";
+    g_gcSchedule = GcSchedule(); // 새 상태는 기본 자동 GC로 시작
 
-    lua = sol::state();
+    // 상태마다 새 풀을 씁니다. 이전 상태는 대입 중에 자기 풀로 닫히고, 그 뒤에 이전 풀을 놓습니다.
+    auto allocator = std::make_unique<LuaPoolAllocator>();
+    lua = sol::state(sol::default_at_panic, &LuaPoolAllocator::Alloc, allocator.get());
+    g_luaAllocator = std::move(allocator);
     lua.open_libraries(
         sol::lib::base,
         sol::lib::package,
@@ -78,14 +93,20 @@ void InitLuaEngine(const char* main) {
     register_input(lua, "is");
     register_draw(lua, "g");
     register_res(lua, "res");
-
-    auto load_result = lua.script_file(main, sol::script_pass_on_error);
-    if (!load_result.valid()) {
-        sol::error err = load_result;
-        printf("[LUA ERROR] %s\n", err.what());
+    InstallChunkSearcher(lua.lua_state());
+
+    lua_State* L = lua.lua_state();
+    int status = LoadLuaChunk(L, main);
+    if (status == LUA_OK) status = lua_pcall(L, 0, 0, 0);
+    if (status != LUA_OK) {
+        printf("[LUA ERROR] %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
         return;
     }
-    printf("Lua Engine Initialized / Reloaded via sol2.\n");
+    printf("Lua Engine Initialized / Reloaded via sol2. (%.1f ms, chunk cache %s: %d hit / %d miss, read %.1f ms, compile %.1f ms)\n",
+        GetTimeMs() - startMs, g_useChunkCache ? "on" : "off",
+        g_chunkCacheStats.hits, g_chunkCacheStats.misses,
+        g_chunkCacheStats.readMs, g_chunkCacheStats.compileMs);
 }
 
 void InitD2D() {
@@ -100,6 +121,7 @@ void InitD2D() {
 
     // DCRT 생성 (실제 사용은 BindDC에서 함)
     g_pD2DFactory->CreateDCRenderTarget(&props, &g_pDCRT);
+    g_pRT = g_pDCRT;
     RebuildAllBitmaps();
 }
 void flush_logs() {
@@ -167,18 +189,30 @@ void drawing() {
         refreshBackBuffer(w, h);
     }
     g_pDCRT->BeginDraw();
-    g_pDCRT->SetTransform(D2D1::Matrix3x2F::Identity());
+    BeginFrameDraw(); // 변환/클립 상태 초기화
     g_pDCRT->Clear(D2D1::ColorF(0, 0, 0, 0)); // GPU 가속 클리어
 
 
-    // 3. Lua Update / Draw 호출
+    // 3. Lua Update / Draw 호출 (깨어날 코루틴은 Update 전에 재개)
+    {
+        HitchPhase hitchPhase(g_watchdog, "async");
+        TickAsyncScheduler(dt);
+    }
+    g_animPool.Update((float)dt); // 모든 애니메이션을 한 번에 진행
+    {
+        HitchPhase hitchPhase(g_watchdog, "tween"); // onComplete 콜백
+        TickTweens(dt);
+    }
     CALL_LUA_FUNC(lua, "Update", dt);
     CALL_LUA_FUNC(lua, "Draw");
+    EndFrameDraw(); // 열린 캔버스와 남은 클립 정리
+    g_luaAllocator->EndFrame();
 
     HRESULT hr = g_pDCRT->EndDraw();
     if (hr == D2DERR_RECREATE_TARGET) {
         SafeRelease(&g_pDCRT);
         InitD2D();
+        g_bufW = g_bufH = 0; // 새 DCRT를 다음 프레임에 다시 BindDC
         return;
     }
 
@@ -217,19 +251,23 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         break;
 
     case WM_LBUTTONDOWN:
-        CALL_LUA_FUNC(lua, "OnMouseDown", (int)LOWORD(lParam), (int)HIWORD(lParam));
+        CALL_LUA_FUNC(lua, "OnMouseDown", (int)LOWORD(lParam), (int)HIWORD(lParam),
+            MouseHitId((int)LOWORD(lParam), (int)HIWORD(lParam)));
         break;
 
     case WM_LBUTTONUP:
-        CALL_LUA_FUNC(lua, "OnMouseUp", (int)LOWORD(lParam), (int)HIWORD(lParam));
+        CALL_LUA_FUNC(lua, "OnMouseUp", (int)LOWORD(lParam), (int)HIWORD(lParam),
+            MouseHitId((int)LOWORD(lParam), (int)HIWORD(lParam)));
         break;
 
     case WM_RBUTTONDOWN:
-        CALL_LUA_FUNC(lua, "OnRightMouseDown", (int)LOWORD(lParam), (int)HIWORD(lParam));
+        CALL_LUA_FUNC(lua, "OnRightMouseDown", (int)LOWORD(lParam), (int)HIWORD(lParam),
+            MouseHitId((int)LOWORD(lParam), (int)HIWORD(lParam)));
         break;
 
     case WM_RBUTTONUP:
-        CALL_LUA_FUNC(lua, "OnRightMouseUp", (int)LOWORD(lParam), (int)HIWORD(lParam));
+        CALL_LUA_FUNC(lua, "OnRightMouseUp", (int)LOWORD(lParam), (int)HIWORD(lParam),
+            MouseHitId((int)LOWORD(lParam), (int)HIWORD(lParam)));
         break;
 
     default:
@@ -264,12 +302,21 @@ int APIENTRY wWinMain(
     int argc;
     LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
 
-    if (argv && argc > 1) {
-        // 인자가 있다면 첫 번째 인자를 entryFile로 설정 (argv[0]은 실행파일 경로)
-        entryFile = to_string(argv[1]);
+    for (int i = 1; argv && i < argc; i++) {
+        std::wstring arg = argv[i];
+        // 캐시 없이 시작 시간을 비교할 때 사용
+        if (arg == L"--no-chunk-cache") {
+            g_useChunkCache = false;
+            printf("[Engine] Lua chunk cache disabled\n");
+            continue;
+        }
+        // 옵션이 아닌 첫 인자를 entryFile로 설정 (argv[0]은 실행파일 경로)
+        entryFile = to_string(arg);
         printf("[Engine] Entry script changed to: %s\n", entryFile.c_str());
+        break;
     }
 
+    SetChunkCacheClock(GetTimeMs); // 읽기/컴파일 시간도 프레임 타이머와 같은 시계로
     InitD2D();
     InitLuaEngine(entryFile.c_str());
 
@@ -300,6 +347,7 @@ int APIENTRY wWinMain(
     MSG msg;
     while (true) {
         ULONGLONG frameStart = GetTickCount64(); // 시작 시간 기록
+        double frameStartMs = GetTimeMs();
         if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
             if (msg.message == WM_QUIT) break;
 
@@ -309,12 +357,16 @@ int APIENTRY wWinMain(
         else {
             drawing();
             flush_logs();
+            UpdateClickThrough();
             if (needReload) {
                 printf("[Win] Reloading Script...\n");
                 InitLuaEngine(entryFile.c_str());
                 CALL_LUA_FUNC(lua, "Init");
                 needReload = false;
             }
+            // 남는 시간에 GC 조각 실행 (sys.gc로 켰을 때만)
+            RunScheduledGC(lua.lua_state(), g_gcSchedule, FRAME_DELAY - (GetTimeMs() - frameStartMs), GetTimeMs);
+
             // 프레임 제어
             ULONGLONG frameTime = GetTickCount64() - frameStart;
             if (frameTime < FRAME_DELAY) {
@@ -323,9 +375,15 @@ int APIENTRY wWinMain(
         }
     }
 
+    g_watchdog.Stop();
+    // Lua 참조를 들고 있는 전역들은 lua가 정적 소멸로 닫히기 전에 비움
+    ResetTweens();
+    StopNavWorkers(); // 작업 스레드가 NotifyTaskReady를 부르지 않게 먼저 멈춤
+    ResetAsyncScheduler();
     if (g_pDCRT) g_pDCRT->Release();
 
     if (g_pWICFactory) g_pWICFactory->Release();
+    ReleaseFontFileLoader();
     if (g_pDWriteFactory) g_pDWriteFactory->Release();
     if (g_pD2DFactory) g_pD2DFactory->Release();
     CoUninitialize();
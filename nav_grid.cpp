@@ -0,0 +1,361 @@
+#include "nav_grid.h"
+#include <algorithm>
+#include <cstdlib>
+
+NavGrid::NavGrid(int w, int h)
+    : width(NavGridSizeOk(w, h) ? w : 0), height(NavGridSizeOk(w, h) ? h : 0) {
+    chunksX = (width + kNavChunkSize - 1) >> kNavChunkShift;
+    chunksY = (height + kNavChunkSize - 1) >> kNavChunkShift;
+    chunks.resize((size_t)chunksX * chunksY);
+    for (auto& c : chunks) c = std::make_shared<NavChunk>();
+}
+
+bool NavGrid::Blocked(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return true;
+    const NavChunk& c = *chunks[ChunkIndex(x, y)];
+    return (c.rows[y & (kNavChunkSize - 1)] >> (x & (kNavChunkSize - 1))) & 1;
+}
+
+NavChunk& NavGrid::MutableChunk(uint32_t index) {
+    // 스냅샷이 같이 들고 있으면 복사해서 고침 (워커가 읽는 중인 청크는 건드리지 않음)
+    auto& c = chunks[index];
+    if (c.use_count() > 1) c = std::make_shared<NavChunk>(*c);
+    c->version = ++version;
+    snapshot.reset();
+    return *c;
+}
+
+void NavGrid::Set(int x, int y, bool blocked) {
+    if (x < 0 || y < 0 || x >= width || y >= height || Blocked(x, y) == blocked) return;
+    NavChunk& c = MutableChunk(ChunkIndex(x, y));
+    const uint16_t bit = (uint16_t)(1u << (x & (kNavChunkSize - 1)));
+    uint16_t& row = c.rows[y & (kNavChunkSize - 1)];
+    row = blocked ? (uint16_t)(row | bit) : (uint16_t)(row & ~bit);
+}
+
+void NavGrid::Fill(int x, int y, int w, int h, bool blocked) {
+    const int x0 = (std::max)(0, x), y0 = (std::max)(0, y);
+    const int x1 = (std::min)(width, x + w), y1 = (std::min)(height, y + h);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    // 청크 단위로 행 마스크를 한 번에 적용, 실제로 바뀐 청크만 버전이 오릅니다.
+    for (int cy = y0 >> kNavChunkShift; cy <= (y1 - 1) >> kNavChunkShift; cy++) {
+        for (int cx = x0 >> kNavChunkShift; cx <= (x1 - 1) >> kNavChunkShift; cx++) {
+            const int bx0 = (std::max)(x0, cx << kNavChunkShift) & (kNavChunkSize - 1);
+            const int bx1 = ((std::min)(x1, (cx + 1) << kNavChunkShift) - 1) & (kNavChunkSize - 1);
+            const uint16_t mask = (uint16_t)(((1u << (bx1 - bx0 + 1)) - 1) << bx0);
+            const int ry0 = (std::max)(y0, cy << kNavChunkShift), ry1 = (std::min)(y1, (cy + 1) << kNavChunkShift);
+            const uint32_t index = (uint32_t)cy * (uint32_t)chunksX + (uint32_t)cx;
+
+            bool changed = false;
+            for (int ry = ry0; ry < ry1 && !changed; ry++) {
+                const uint16_t row = chunks[index]->rows[ry & (kNavChunkSize - 1)];
+                changed = blocked ? (row & mask) != mask : (row & mask) != 0;
+            }
+            if (!changed) continue;
+
+            NavChunk& c = MutableChunk(index);
+            for (int ry = ry0; ry < ry1; ry++) {
+                uint16_t& row = c.rows[ry & (kNavChunkSize - 1)];
+                row = blocked ? (uint16_t)(row | mask) : (uint16_t)(row & ~mask);
+            }
+        }
+    }
+}
+
+std::shared_ptr<const NavSnapshot> NavGrid::Snapshot() {
+    if (!snapshot) {
+        auto s = std::make_shared<NavSnapshot>();
+        s->width = width;
+        s->height = height;
+        s->chunksX = chunksX;
+        s->chunks.assign(chunks.begin(), chunks.end());
+        snapshot = std::move(s);
+    }
+    return snapshot;
+}
+
+bool NavGrid::IsCurrent(const NavDeps& deps) const {
+    for (const auto& [index, ver] : deps.chunks) {
+        if (index >= chunks.size() || chunks[index]->version != ver) return false;
+    }
+    return true;
+}
+
+// --- 탐색 ---
+namespace {
+constexpr int kDirX[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+constexpr int kDirY[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+constexpr uint8_t kOpposite[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+constexpr uint32_t kStraight = 10, kDiagonal = 14;
+
+// 칸 수가 kNavMaxCells 이하라 uint32로 넘치지 않음
+inline uint32_t CellIndex(int x, int y, int w) {
+    return (uint32_t)y * (uint32_t)w + (uint32_t)x;
+}
+
+// 스레드마다 하나. 격자 크기만큼 한 번 잡아 두고 세대 번호로 초기화를 대신합니다.
+// 칸마다 12바이트라, 훨씬 작은 격자를 풀면 큰 격자 때 늘려 둔 것을 놓습니다.
+constexpr size_t kScratchKeepCells = (size_t)1 << 16;
+
+struct SearchScratch {
+    std::vector<uint32_t> g, parent, stamp; // stamp == gen: 열림, gen + 1: 닫힘
+    std::vector<uint32_t> chunkStamp;       // == gen: 이번 탐색에서 이미 deps에 넣은 청크
+    // 비용 버킷 링. 한 번 펼칠 때 f(또는 거리)가 늘어나는 폭이 최대 28(간선 14 + 휴리스틱 14)이라 32칸이면 겹치지 않음
+    std::vector<uint32_t> buckets[32];
+    uint32_t gen = 0;
+
+    void Prepare(size_t cells, size_t chunkCount) {
+        if (cells && g.size() > kScratchKeepCells && g.size() / 4 > cells) {
+            std::vector<uint32_t>().swap(g);
+            std::vector<uint32_t>().swap(parent);
+            std::vector<uint32_t>().swap(stamp);
+            std::vector<uint32_t>().swap(chunkStamp);
+        }
+        if (g.size() < cells) {
+            g.resize(cells);
+            parent.resize(cells);
+            stamp.resize(cells, 0);
+        }
+        if (chunkStamp.size() < chunkCount) chunkStamp.resize(chunkCount, 0);
+        gen += 2;
+        if (gen >= 0xFFFFFFF0u) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(chunkStamp.begin(), chunkStamp.end(), 0);
+            gen = 2;
+        }
+        for (auto& b : buckets) b.clear();
+    }
+};
+thread_local SearchScratch t_scratch;
+
+// 읽은 칸의 청크를 deps에 기록하면서 격자를 읽음
+struct TrackedGrid {
+    const NavSnapshot& grid;
+    SearchScratch& s;
+    NavDeps& deps;
+
+    void MarkChunk(uint32_t chunk) {
+        if (s.chunkStamp[chunk] == s.gen) return;
+        s.chunkStamp[chunk] = s.gen;
+        deps.chunks.emplace_back(chunk, grid.ChunkVersion(chunk));
+    }
+    // 한 칸만 읽을 때 (크기는 바뀌지 않으니 범위 밖은 기록할 필요 없음)
+    bool Walkable(int x, int y) {
+        if (!grid.InBounds(x, y)) return false;
+        MarkChunk(grid.ChunkIndex(x, y));
+        return !grid.Blocked(x, y);
+    }
+    // (x, y)를 펼칠 때 읽는 3x3 칸의 청크. 대부분 청크 안쪽이라 하나로 끝납니다.
+    void TouchAround(int x, int y) {
+        const int x0 = (std::max)(0, x - 1), x1 = (std::min)(grid.Width() - 1, x + 1);
+        const int y0 = (std::max)(0, y - 1), y1 = (std::min)(grid.Height() - 1, y + 1);
+        const uint32_t first = grid.ChunkIndex(x0, y0), last = grid.ChunkIndex(x1, y1);
+        if (first == last) {
+            MarkChunk(first);
+            return;
+        }
+        // 3칸 폭이라 가로세로 최대 두 청크, 네 모서리만 보면 됨
+        MarkChunk(first);
+        MarkChunk(grid.ChunkIndex(x1, y0));
+        MarkChunk(grid.ChunkIndex(x0, y1));
+        MarkChunk(last);
+    }
+
+    // (x, y)에서 갈 수 있는 방향 비트 (대각선은 양옆이 뚫려 있어야 함)
+    uint32_t OpenDirections(int x, int y, bool diagonal) {
+        TouchAround(x, y);
+        uint32_t open = 0;
+        for (int d = 0; d < 4; d++) {
+            if (!grid.Blocked(x + kDirX[d], y + kDirY[d])) open |= 1u << d;
+        }
+        if (!diagonal) return open;
+        for (int d = 4; d < 8; d++) {
+            const uint32_t sides = (1u << (kDirX[d] < 0 ? 2 : 3)) | (1u << (kDirY[d] < 0 ? 0 : 1));
+            if ((open & sides) == sides && !grid.Blocked(x + kDirX[d], y + kDirY[d])) open |= 1u << d;
+        }
+        return open;
+    }
+};
+
+uint32_t Heuristic(int x, int y, int tx, int ty, bool diagonal) {
+    const uint32_t dx = (uint32_t)std::abs(x - tx), dy = (uint32_t)std::abs(y - ty);
+    if (!diagonal) return kStraight * (dx + dy);
+    return kStraight * (std::max)(dx, dy) + (kDiagonal - kStraight) * (std::min)(dx, dy);
+}
+}
+
+size_t NavScratchBytes() {
+    const SearchScratch& s = t_scratch;
+    size_t bytes = (s.g.capacity() + s.parent.capacity() + s.stamp.capacity() + s.chunkStamp.capacity()) * sizeof(uint32_t);
+    for (const auto& b : s.buckets) bytes += b.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+void NavDirection(uint8_t dir, int& dx, int& dy) {
+    if (dir >= 8) {
+        dx = dy = 0;
+        return;
+    }
+    dx = kDirX[dir];
+    dy = kDirY[dir];
+}
+
+NavPath FindNavPath(const NavSnapshot& grid, int sx, int sy, int tx, int ty, bool diagonal) {
+    NavPath path;
+    SearchScratch& s = t_scratch;
+    s.Prepare((size_t)grid.Width() * grid.Height(), grid.ChunkCount());
+    TrackedGrid tg{ grid, s, path.deps };
+    if (!tg.Walkable(sx, sy) || !tg.Walkable(tx, ty)) return path;
+
+    const int w = grid.Width();
+    const uint32_t open = s.gen, closed = s.gen + 1;
+    const uint32_t start = CellIndex(sx, sy, w), goal = CellIndex(tx, ty, w);
+
+    // f 값별 버킷 큐. 휴리스틱이 일관적이라 f가 줄지 않으므로 힙이 필요 없고,
+    // 같은 f 안에서는 나중에 넣은(목표 쪽으로 더 깊이 들어간) 노드부터 꺼냅니다.
+    s.g[start] = 0;
+    s.parent[start] = start;
+    s.stamp[start] = open;
+    uint32_t f = Heuristic(sx, sy, tx, ty, diagonal);
+    s.buckets[f & 31].push_back(start);
+    size_t pending = 1;
+
+    for (; pending > 0; f++) {
+        auto& bucket = s.buckets[f & 31];
+        while (!bucket.empty()) {
+            const uint32_t idx = bucket.back();
+            bucket.pop_back();
+            pending--;
+            // 더 싼 g로 다시 넣은 항목이 먼저 처리되므로 남은 옛 항목은 이미 닫혀 있음
+            if (s.stamp[idx] == closed) continue;
+            s.stamp[idx] = closed;
+            path.expanded++;
+
+            if (idx == goal) {
+                path.found = true;
+                path.cost = s.g[idx];
+                for (uint32_t i = goal;; i = s.parent[i]) {
+                    path.points.push_back((int32_t)(i % w));
+                    path.points.push_back((int32_t)(i / w));
+                    if (i == start) break;
+                }
+                // (x, y) 쌍 순서를 뒤집어 출발점부터
+                for (size_t a = 0, b = path.points.size() - 2; a < b; a += 2, b -= 2) {
+                    std::swap(path.points[a], path.points[b]);
+                    std::swap(path.points[a + 1], path.points[b + 1]);
+                }
+                return path;
+            }
+
+            const int x = (int)(idx % w), y = (int)(idx / w);
+            const uint32_t dirs = tg.OpenDirections(x, y, diagonal);
+            for (int d = 0; d < 8; d++) {
+                if (!(dirs & (1u << d))) continue;
+                const int nx = x + kDirX[d], ny = y + kDirY[d];
+                const uint32_t n = CellIndex(nx, ny, w);
+                if (s.stamp[n] == closed) continue;
+                const uint32_t ng = s.g[idx] + (d < 4 ? kStraight : kDiagonal);
+                if (s.stamp[n] == open && ng >= s.g[n]) continue;
+                s.g[n] = ng;
+                s.parent[n] = idx;
+                s.stamp[n] = open;
+                s.buckets[(ng + Heuristic(nx, ny, tx, ty, diagonal)) & 31].push_back(n);
+                pending++;
+            }
+        }
+    }
+    return path;
+}
+
+NavFlowField BuildNavFlowField(const NavSnapshot& grid, int tx, int ty, bool diagonal) {
+    NavFlowField field;
+    field.width = grid.Width();
+    field.height = grid.Height();
+    field.goalX = tx;
+    field.goalY = ty;
+    const size_t cells = (size_t)field.width * field.height;
+    field.dist.assign(cells, NavFlowField::kUnreachable);
+    field.dir.assign(cells, NavFlowField::kNone);
+
+    SearchScratch& s = t_scratch;
+    s.Prepare(0, grid.ChunkCount());
+    TrackedGrid tg{ grid, s, field.deps };
+    if (!tg.Walkable(tx, ty)) return field;
+
+    // 목표에서 거꾸로 퍼지는 다익스트라. 간선 비용이 10/14뿐이라 버킷 링으로 충분합니다.
+    const int w = field.width;
+    const uint32_t goal = CellIndex(tx, ty, w);
+    field.dist[goal] = 0;
+    s.buckets[0].push_back(goal);
+    size_t pending = 1;
+
+    for (uint32_t current = 0; pending > 0; current++) {
+        auto& bucket = s.buckets[current & 31];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            const uint32_t idx = bucket[i];
+            if (field.dist[idx] != current) continue; // 더 짧은 경로로 이미 처리됨
+
+            const int x = (int)(idx % w), y = (int)(idx / w);
+            const uint32_t dirs = tg.OpenDirections(x, y, diagonal);
+            for (int d = 0; d < 8; d++) {
+                if (!(dirs & (1u << d))) continue;
+                const uint32_t n = CellIndex(x + kDirX[d], y + kDirY[d], w);
+                const uint32_t nd = current + (d < 4 ? kStraight : kDiagonal);
+                if (nd >= field.dist[n]) continue;
+                field.dist[n] = nd;
+                field.dir[n] = kOpposite[d]; // n에서 idx로 가는 방향
+                s.buckets[nd & 31].push_back(n);
+                pending++;
+            }
+        }
+        pending -= bucket.size();
+        bucket.clear();
+    }
+    return field;
+}
+
+// --- 작업 스레드 ---
+NavWorkers::NavWorkers(size_t count) : threadCount((std::max)((size_t)1, count)) {}
+
+void NavWorkers::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+        // 처음 쓸 때 스레드를 띄움
+        if (threads.empty()) {
+            stopping = false;
+            for (size_t i = 0; i < threadCount; i++) threads.emplace_back(&NavWorkers::Run, this);
+        }
+    }
+    wake.notify_one();
+}
+
+void NavWorkers::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+    threads.clear();
+}
+
+size_t NavWorkers::Pending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
+
+void NavWorkers::Run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping) return;
+        std::function<void()> job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
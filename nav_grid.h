@@ -0,0 +1,134 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 격자 길찾기 (플랫폼 독립, Lua 의존성 없음)
+// 막힘 여부는 16x16 청크마다 비트 16개짜리 행 16개(32바이트)로 저장합니다.
+// 청크는 shared_ptr로 공유되어서 스냅샷은 청크 포인터만 복사하고,
+// 스냅샷이 잡고 있는 청크를 고치면 그 청크만 복사한 뒤 고칩니다(copy-on-write).
+// 워커 스레드는 스냅샷만 읽으므로 메인 스레드가 그동안 격자를 고쳐도 됩니다.
+constexpr int kNavChunkShift = 4;
+constexpr int kNavChunkSize = 1 << kNavChunkShift;
+// 칸 수 상한 (약 16M). 칸 인덱스는 uint32로 계산하고, 탐색 버퍼도 이 크기까지만 잡습니다.
+constexpr size_t kNavMaxCells = (size_t)1 << 24;
+
+// 가로세로는 1~0xFFFF (좌표를 16비트 키로 묶어 캐시함), 칸 수는 kNavMaxCells 이하
+inline bool NavGridSizeOk(int w, int h) {
+    return w > 0 && h > 0 && w <= 0xFFFF && h <= 0xFFFF && (size_t)w * (size_t)h <= kNavMaxCells;
+}
+
+struct NavChunk {
+    uint16_t rows[kNavChunkSize] = {}; // 비트 1 = 막힘
+    uint32_t version = 0;              // 고칠 때마다 격자 전체 카운터에서 새 값을 받음
+};
+
+// 탐색이 읽은 청크와 그때의 버전. 이 청크들이 그대로면 같은 탐색은 같은 결과를 냅니다.
+struct NavDeps {
+    std::vector<std::pair<uint32_t, uint32_t>> chunks; // 청크 인덱스, 버전
+};
+
+// 읽기 전용 격자. 워커 스레드가 들고 다닙니다.
+class NavSnapshot {
+public:
+    int Width() const { return width; }
+    int Height() const { return height; }
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    // 범위 밖은 막힌 것으로 봅니다.
+    bool Blocked(int x, int y) const {
+        if (!InBounds(x, y)) return true;
+        const NavChunk& c = *chunks[ChunkIndex(x, y)];
+        return (c.rows[y & (kNavChunkSize - 1)] >> (x & (kNavChunkSize - 1))) & 1;
+    }
+    uint32_t ChunkIndex(int x, int y) const { return (uint32_t)(y >> kNavChunkShift) * (uint32_t)chunksX + (uint32_t)(x >> kNavChunkShift); }
+    uint32_t ChunkVersion(uint32_t chunk) const { return chunks[chunk]->version; }
+    size_t ChunkCount() const { return chunks.size(); }
+
+private:
+    friend class NavGrid;
+    int width = 0, height = 0, chunksX = 0;
+    std::vector<std::shared_ptr<const NavChunk>> chunks;
+};
+
+// 메인 스레드에서 고치는 격자
+class NavGrid {
+public:
+    // NavGridSizeOk가 아니면 0x0 격자 (모든 칸이 범위 밖 = 막힘)
+    NavGrid(int width, int height);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    bool Blocked(int x, int y) const;
+    void Set(int x, int y, bool blocked);
+    void Fill(int x, int y, int w, int h, bool blocked);
+    uint32_t Version() const { return version; }
+
+    // 고친 게 없으면 직전 스냅샷을 그대로 돌려줍니다.
+    std::shared_ptr<const NavSnapshot> Snapshot();
+    // deps가 읽은 청크가 하나도 안 바뀌었는지
+    bool IsCurrent(const NavDeps& deps) const;
+
+private:
+    uint32_t ChunkIndex(int x, int y) const { return (uint32_t)(y >> kNavChunkShift) * (uint32_t)chunksX + (uint32_t)(x >> kNavChunkShift); }
+    NavChunk& MutableChunk(uint32_t index);
+
+    int width, height, chunksX, chunksY;
+    std::vector<std::shared_ptr<NavChunk>> chunks;
+    std::shared_ptr<const NavSnapshot> snapshot;
+    uint32_t version = 0;
+};
+
+// --- 탐색 ---
+// 이동은 상하좌우(비용 10)와, diagonal이면 대각선(비용 14). 대각선은 양옆이 모두 뚫려 있어야 합니다.
+struct NavPath {
+    bool found = false;
+    uint32_t cost = 0;              // 10 = 한 칸
+    std::vector<int32_t> points;    // x0, y0, x1, y1, ... (출발점과 도착점 포함)
+    uint32_t expanded = 0;          // 닫은 노드 수
+    NavDeps deps;
+};
+NavPath FindNavPath(const NavSnapshot& grid, int sx, int sy, int tx, int ty, bool diagonal);
+
+// 목표 하나를 향하는 흐름장. 같은 목표로 가는 유닛 여럿이 하나를 같이 씁니다.
+struct NavFlowField {
+    static constexpr uint8_t kNone = 0xFF;  // 목표 자신이거나 도달 불가
+    static constexpr uint32_t kUnreachable = 0xFFFFFFFFu;
+
+    int width = 0, height = 0;
+    int goalX = 0, goalY = 0;
+    std::vector<uint32_t> dist;  // 목표까지 비용
+    std::vector<uint8_t> dir;    // 다음 칸 방향 (NavDirection 인덱스)
+    NavDeps deps;
+};
+NavFlowField BuildNavFlowField(const NavSnapshot& grid, int tx, int ty, bool diagonal);
+// 0~3: 상하좌우, 4~7: 대각선
+void NavDirection(uint8_t dir, int& dx, int& dy);
+// 이 스레드의 탐색 버퍼 크기 (FindNavPath가 칸마다 12바이트를 잡아 둠)
+size_t NavScratchBytes();
+
+// 길찾기용 작업 스레드. 넣은 순서대로 처리하고, Stop하면 남은 작업은 버립니다.
+class NavWorkers {
+public:
+    explicit NavWorkers(size_t threadCount);
+    ~NavWorkers() { Stop(); }
+    void Submit(std::function<void()> job);
+    void Stop();
+    size_t Pending();
+
+private:
+    void Run();
+
+    size_t threadCount;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+};
@@ -0,0 +1,210 @@
+#include "particles.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+// PARTICLE_SIMD_WIDTH를 밖에서 정의하면 그 폭으로 고정합니다. (벤치마크의 스칼라 빌드용)
+#if !defined(PARTICLE_SIMD_WIDTH)
+#if defined(__AVX__)
+#define PARTICLE_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_SIMD_WIDTH 4
+#else
+#define PARTICLE_SIMD_WIDTH 1
+#endif
+#endif
+
+#if PARTICLE_SIMD_WIDTH == 8
+#include <immintrin.h>
+#elif PARTICLE_SIMD_WIDTH == 4
+#include <emmintrin.h>
+#endif
+
+int ParticleSimdWidth() { return PARTICLE_SIMD_WIDTH; }
+
+// 에미터마다 다른 시드: 생성 순번을 섞어서 씁니다.
+static std::atomic<uint32_t> g_emitterSeq{ 0 };
+
+ParticleEmitter::ParticleEmitter() {
+    Seed(g_emitterSeq.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B9u + 0x7F4A7C15u);
+}
+
+void ParticleEmitter::Seed(uint32_t seed) {
+    // murmur3 fmix32로 비슷한 시드도 흩어지게 하고, xorshift는 0 상태에서 멈추므로 피합니다.
+    seed ^= seed >> 16;
+    seed *= 0x85EBCA6Bu;
+    seed ^= seed >> 13;
+    seed *= 0xC2B2AE35u;
+    seed ^= seed >> 16;
+    rng = seed ? seed : 0x9E3779B9u;
+}
+
+void ParticleEmitter::Reserve(uint32_t n) {
+    if (n <= px.size()) return;
+
+    size_t cap = std::max<size_t>(n, px.size() * 2);
+    cap = (cap + 7) & ~size_t(7);
+    for (auto* v : { &px, &py, &vx, &vy, &life, &invLife, &rot, &spin, &size, &r, &g, &b, &a }) {
+        v->resize(cap);
+    }
+}
+
+float ParticleEmitter::Random(float lo, float hi) {
+    // xorshift32: 파티클 방출에는 이 정도면 충분합니다.
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    float t = (rng >> 8) * (1.0f / 16777216.0f);
+    return lo + (hi - lo) * t;
+}
+
+void ParticleEmitter::Emit(uint32_t n) {
+    const uint32_t cap = std::min(maxCount, kMaxCount);
+    const uint32_t room = cap > count ? cap - count : 0;
+    if (n > room) n = room;
+    if (n == 0) return;
+    Reserve(count + n);
+
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t i = count++;
+        float angle = direction + Random(-spread * 0.5f, spread * 0.5f);
+        float speed = Random(speedMin, speedMax);
+        float l = std::max(Random(lifeMin, lifeMax), 0.001f);
+
+        px[i] = x + Random(-spreadX, spreadX);
+        py[i] = y + Random(-spreadY, spreadY);
+        vx[i] = std::cos(angle) * speed;
+        vy[i] = std::sin(angle) * speed;
+        life[i] = l;
+        invLife[i] = 1.0f / l;
+        rot[i] = 0.0f;
+        spin[i] = Random(spinMin, spinMax);
+        size[i] = sizeStart;
+        r[i] = colorStart[0];
+        g[i] = colorStart[1];
+        b[i] = colorStart[2];
+        a[i] = colorStart[3];
+    }
+}
+
+// [begin, end) 구간을 스칼라로 적분 (SIMD 꼬리 처리 및 폴백)
+void ParticleEmitter::Integrate(uint32_t begin, uint32_t end, float dt) {
+    const float dragK = std::max(0.0f, 1.0f - drag * dt);
+    const float gx = gravityX * dt, gy = gravityY * dt;
+    const float dSize = sizeEnd - sizeStart;
+    const float dr = colorEnd[0] - colorStart[0], dg = colorEnd[1] - colorStart[1];
+    const float db = colorEnd[2] - colorStart[2], da = colorEnd[3] - colorStart[3];
+
+    for (uint32_t i = begin; i < end; i++) {
+        life[i] -= dt;
+        float t = std::clamp(1.0f - life[i] * invLife[i], 0.0f, 1.0f);
+
+        vx[i] = (vx[i] + gx) * dragK;
+        vy[i] = (vy[i] + gy) * dragK;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        rot[i] += spin[i] * dt;
+
+        size[i] = sizeStart + dSize * t;
+        r[i] = colorStart[0] + dr * t;
+        g[i] = colorStart[1] + dg * t;
+        b[i] = colorStart[2] + db * t;
+        a[i] = colorStart[3] + da * t;
+    }
+}
+
+void ParticleEmitter::Compact() {
+    // 죽은 파티클은 마지막 원소와 교체해서 제거 (순서는 보장하지 않음)
+    uint32_t i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) { i++; continue; }
+
+        uint32_t last = --count;
+        if (i != last) {
+            for (auto* v : { &px, &py, &vx, &vy, &life, &invLife, &rot, &spin, &size, &r, &g, &b, &a }) {
+                (*v)[i] = (*v)[last];
+            }
+        }
+    }
+}
+
+void ParticleEmitter::Update(float dt) {
+    if (dt <= 0.0f) return;
+
+    uint32_t i = 0;
+#if PARTICLE_SIMD_WIDTH == 8
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vdrag = _mm256_set1_ps(std::max(0.0f, 1.0f - drag * dt));
+    const __m256 vgx = _mm256_set1_ps(gravityX * dt), vgy = _mm256_set1_ps(gravityY * dt);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 s0 = _mm256_set1_ps(sizeStart), ds = _mm256_set1_ps(sizeEnd - sizeStart);
+    __m256 c0[4], dc[4];
+    for (int c = 0; c < 4; c++) {
+        c0[c] = _mm256_set1_ps(colorStart[c]);
+        dc[c] = _mm256_set1_ps(colorEnd[c] - colorStart[c]);
+    }
+    float* out[4] = { r.data(), g.data(), b.data(), a.data() };
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(&life[i]), vdt);
+        _mm256_storeu_ps(&life[i], l);
+        __m256 t = _mm256_sub_ps(one, _mm256_mul_ps(l, _mm256_loadu_ps(&invLife[i])));
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+
+        __m256 velX = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&vx[i]), vgx), vdrag);
+        __m256 velY = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&vy[i]), vgy), vdrag);
+        _mm256_storeu_ps(&vx[i], velX);
+        _mm256_storeu_ps(&vy[i], velY);
+        _mm256_storeu_ps(&px[i], _mm256_add_ps(_mm256_loadu_ps(&px[i]), _mm256_mul_ps(velX, vdt)));
+        _mm256_storeu_ps(&py[i], _mm256_add_ps(_mm256_loadu_ps(&py[i]), _mm256_mul_ps(velY, vdt)));
+        _mm256_storeu_ps(&rot[i], _mm256_add_ps(_mm256_loadu_ps(&rot[i]), _mm256_mul_ps(_mm256_loadu_ps(&spin[i]), vdt)));
+
+        _mm256_storeu_ps(&size[i], _mm256_add_ps(s0, _mm256_mul_ps(ds, t)));
+        for (int c = 0; c < 4; c++) {
+            _mm256_storeu_ps(out[c] + i, _mm256_add_ps(c0[c], _mm256_mul_ps(dc[c], t)));
+        }
+    }
+#elif PARTICLE_SIMD_WIDTH == 4
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdrag = _mm_set1_ps(std::max(0.0f, 1.0f - drag * dt));
+    const __m128 vgx = _mm_set1_ps(gravityX * dt), vgy = _mm_set1_ps(gravityY * dt);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 s0 = _mm_set1_ps(sizeStart), ds = _mm_set1_ps(sizeEnd - sizeStart);
+    __m128 c0[4], dc[4];
+    for (int c = 0; c < 4; c++) {
+        c0[c] = _mm_set1_ps(colorStart[c]);
+        dc[c] = _mm_set1_ps(colorEnd[c] - colorStart[c]);
+    }
+    float* out[4] = { r.data(), g.data(), b.data(), a.data() };
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(&life[i]), vdt);
+        _mm_storeu_ps(&life[i], l);
+        __m128 t = _mm_sub_ps(one, _mm_mul_ps(l, _mm_loadu_ps(&invLife[i])));
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+        __m128 velX = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&vx[i]), vgx), vdrag);
+        __m128 velY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&vy[i]), vgy), vdrag);
+        _mm_storeu_ps(&vx[i], velX);
+        _mm_storeu_ps(&vy[i], velY);
+        _mm_storeu_ps(&px[i], _mm_add_ps(_mm_loadu_ps(&px[i]), _mm_mul_ps(velX, vdt)));
+        _mm_storeu_ps(&py[i], _mm_add_ps(_mm_loadu_ps(&py[i]), _mm_mul_ps(velY, vdt)));
+        _mm_storeu_ps(&rot[i], _mm_add_ps(_mm_loadu_ps(&rot[i]), _mm_mul_ps(_mm_loadu_ps(&spin[i]), vdt)));
+
+        _mm_storeu_ps(&size[i], _mm_add_ps(s0, _mm_mul_ps(ds, t)));
+        for (int c = 0; c < 4; c++) {
+            _mm_storeu_ps(out[c] + i, _mm_add_ps(c0[c], _mm_mul_ps(dc[c], t)));
+        }
+    }
+#endif
+    Integrate(i, count, dt);
+    Compact();
+
+    // 방출은 적분 뒤에 해서 새 파티클이 첫 프레임을 시작값으로 그려지게 합니다.
+    spawnAccum += rate * dt;
+    if (spawnAccum >= 1.0f) {
+        uint32_t n = (uint32_t)spawnAccum;
+        spawnAccum -= (float)n;
+        Emit(n);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 파티클 에미터 (플랫폼 독립, D2D/Lua 의존성 없음)
+// 데이터는 SoA로 보관해서 Update 커널을 SSE/AVX로 돌립니다.
+// 시간 단위는 초, 속도는 px/s 입니다. (Lua 쪽 dt(ms)는 바인딩에서 변환)
+struct ParticleEmitter {
+    // maxCount가 얼마든 한 에미터가 가질 수 있는 최대 파티클 수
+    static constexpr uint32_t kMaxCount = 1u << 20;
+
+    // --- 에미터 설정 ---
+    int imageId = -1;         // g_bitmapTable 인덱스, -1이면 색 사각형으로 그림
+    float x = 0.0f, y = 0.0f; // 방출 위치
+    float spreadX = 0.0f, spreadY = 0.0f; // 방출 위치 랜덤 범위 (±)
+    float rate = 0.0f;        // 초당 방출 개수
+    float lifeMin = 1.0f, lifeMax = 1.0f;
+    float speedMin = 0.0f, speedMax = 0.0f;
+    float direction = 0.0f;   // 방출 방향 (라디안)
+    float spread = 6.2831853f; // 방출 각도 범위 (라디안)
+    float gravityX = 0.0f, gravityY = 0.0f;
+    float drag = 0.0f;        // 초당 감속 비율 (0 = 없음)
+    float spinMin = 0.0f, spinMax = 0.0f; // 회전 속도 (라디안/s)
+    float sizeStart = 8.0f, sizeEnd = 8.0f;
+    float colorStart[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float colorEnd[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+    uint32_t maxCount = 10000;
+
+    // --- SoA 파티클 데이터 ---
+    std::vector<float> px, py;     // 위치
+    std::vector<float> vx, vy;     // 속도
+    std::vector<float> life;       // 남은 수명
+    std::vector<float> invLife;    // 1 / 최대 수명
+    std::vector<float> rot, spin;  // 회전
+    std::vector<float> size;       // size-over-life 결과
+    std::vector<float> r, g, b, a; // color-over-life 결과
+
+    uint32_t count = 0;
+
+    ParticleEmitter();
+
+    void Update(float dt);
+    void Emit(uint32_t n);
+    void Clear() { count = 0; }
+    void Seed(uint32_t seed);
+
+private:
+    float spawnAccum = 0.0f;
+    uint32_t rng;
+
+    void Reserve(uint32_t n);
+    float Random(float lo, float hi);
+    void Integrate(uint32_t begin, uint32_t end, float dt);
+    void Compact();
+};
+
+// 이 빌드에서 Update 커널이 한 번에 처리하는 float 개수 (1이면 스칼라)
+int ParticleSimdWidth();
@@ -0,0 +1,136 @@
+#include "sprite_anim.h"
+#include <cmath>
+
+int SpriteSheet::FindTag(std::string_view name) const {
+    for (size_t i = 0; i < tags.size(); i++) {
+        if (tags[i].name == name) return (int)i;
+    }
+    return -1;
+}
+
+int SpriteSheet::FindFrame(std::string_view name) const {
+    auto it = frameNames.find(std::string(name));
+    return it == frameNames.end() ? -1 : it->second;
+}
+
+AnimHandle AnimPool::Create(const SpriteSheet* sheet, int tag) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = (uint32_t)generations.size();
+        generations.push_back(0);
+        denseIndex.push_back(0);
+    }
+
+    denseIndex[slot] = (uint32_t)anims.size();
+    AnimState& a = anims.emplace_back();
+    a.sheet = sheet;
+    a.slot = slot;
+    Play(a, tag);
+    return { slot, generations[slot] };
+}
+
+void AnimPool::Destroy(AnimHandle h) {
+    if (!Get(h)) return;
+
+    // 마지막 상태를 빈 자리로 옮기고 역참조를 갱신
+    uint32_t idx = denseIndex[h.slot];
+    if (idx + 1 != anims.size()) {
+        anims[idx] = anims.back();
+        denseIndex[anims[idx].slot] = idx;
+    }
+    anims.pop_back();
+
+    generations[h.slot]++;
+    freeSlots.push_back(h.slot);
+}
+
+AnimState* AnimPool::Get(AnimHandle h) {
+    if (h.slot >= generations.size() || generations[h.slot] != h.generation) return nullptr;
+    return &anims[denseIndex[h.slot]];
+}
+
+void AnimPool::Play(AnimState& a, int tag, int repeat) {
+    const SpriteSheet& sheet = *a.sheet;
+    if (tag < 0 || tag >= (int)sheet.tags.size()) tag = -1;
+
+    a.tag = tag;
+    if (tag >= 0) {
+        const AnimTag& t = sheet.tags[tag];
+        a.from = t.from;
+        a.to = t.to;
+        a.direction = t.direction;
+        a.repeat = repeat < 0 ? t.repeat : repeat;
+    }
+    else {
+        a.from = 0;
+        a.to = (int)sheet.frames.size() - 1;
+        a.direction = AnimDirection::Forward;
+        a.repeat = repeat < 0 ? 0 : repeat;
+    }
+
+    const bool reverse = a.direction == AnimDirection::Reverse || a.direction == AnimDirection::PingPongReverse;
+    a.step = reverse ? -1 : 1;
+    a.frame = reverse ? a.to : a.from;
+    a.loops = 0;
+    a.timeMs = 0.0f;
+    a.playing = true;
+    a.done = false;
+
+    a.cycleMs = 0.0f;
+    for (int i = a.from; i <= a.to; i++) a.cycleMs += sheet.frames[i].durationMs;
+}
+
+// 다음 프레임으로. 구간 끝에서 반복/왕복/정지를 처리합니다.
+static void Advance(AnimState& a) {
+    const int next = a.frame + a.step;
+    if (next >= a.from && next <= a.to) {
+        a.frame = next;
+        return;
+    }
+
+    const bool pingPong = a.direction == AnimDirection::PingPong || a.direction == AnimDirection::PingPongReverse;
+    if (pingPong && a.from != a.to) {
+        // 시작한 쪽 끝으로 돌아왔을 때만 한 바퀴로 셉니다.
+        const bool cycleEnd = a.direction == AnimDirection::PingPong ? next < a.from : next > a.to;
+        a.step = -a.step;
+        if (!cycleEnd) {
+            a.frame += a.step;
+            return;
+        }
+    }
+
+    a.loops++;
+    if (a.repeat > 0 && (int)a.loops >= a.repeat) {
+        a.playing = false;
+        a.done = true;
+        a.timeMs = 0.0f;
+        return;
+    }
+
+    if (pingPong && a.from != a.to) a.frame += a.step;
+    else a.frame = a.step > 0 ? a.from : a.to;
+}
+
+void AnimPool::Update(float dtms) {
+    if (dtms <= 0.0f) return;
+
+    for (AnimState& a : anims) {
+        if (!a.playing || a.speed <= 0.0f) continue;
+
+        const SpriteFrame* frames = a.sheet->frames.data();
+        a.timeMs += dtms * a.speed;
+
+        // 창을 오래 멈췄다 돌아온 경우 등: 무한 반복이면 한 바퀴 안으로 접어서 루프 횟수를 제한
+        if (a.repeat == 0 && a.cycleMs > 0.0f && a.timeMs > a.cycleMs * 2.0f)
+            a.timeMs = fmodf(a.timeMs, a.cycleMs);
+
+        while (a.playing && a.timeMs >= frames[a.frame].durationMs) {
+            a.timeMs -= frames[a.frame].durationMs;
+            Advance(a);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 스프라이트 시트 / 애니메이션 (플랫폼 독립, D2D/Lua 의존성 없음)
+// 시트는 Aseprite/TexturePacker JSON에서 읽은 프레임 사각형과 태그를 들고 있고,
+// 애니메이션 상태는 AnimPool에 몰아 두어 매 프레임 한 번에 진행합니다. 시간 단위는 ms 입니다.
+struct SpriteFrame {
+    float sx = 0.0f, sy = 0.0f, sw = 0.0f, sh = 0.0f; // 이미지 안의 소스 사각형
+    float ox = 0.0f, oy = 0.0f; // 트리밍된 프레임이 원래 크기 안에서 놓이는 위치 (spriteSourceSize)
+    float w = 0.0f, h = 0.0f;   // 트리밍 전 원래 크기 (sourceSize)
+    float durationMs = 100.0f;
+};
+
+enum class AnimDirection : uint8_t { Forward, Reverse, PingPong, PingPongReverse };
+
+struct AnimTag {
+    std::string name;
+    int from = 0, to = 0; // 포함 범위
+    AnimDirection direction = AnimDirection::Forward;
+    int repeat = 0;       // 0이면 무한 반복
+};
+
+struct SpriteSheet {
+    int imageId = -1;
+    std::vector<SpriteFrame> frames;
+    std::vector<AnimTag> tags;
+    std::unordered_map<std::string, int> frameNames;
+
+    int FindTag(std::string_view name) const;   // 없으면 -1
+    int FindFrame(std::string_view name) const; // 없으면 -1
+};
+
+struct AnimHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+struct AnimState {
+    const SpriteSheet* sheet = nullptr;
+    int tag = -1;         // -1이면 시트 전체 프레임
+    int frame = 0;        // sheet->frames 인덱스
+    int from = 0, to = 0;
+    int step = 1;         // 진행 방향 (+1 / -1)
+    AnimDirection direction = AnimDirection::Forward;
+    int repeat = 0;
+    uint32_t loops = 0;   // 한 바퀴 끝날 때마다 증가
+    float timeMs = 0.0f;  // 현재 프레임에서 지난 시간
+    float cycleMs = 0.0f; // 한 바퀴 길이 (큰 dt를 접을 때 사용)
+    float speed = 1.0f;
+    bool playing = true;
+    bool done = false;    // repeat 횟수를 다 채우고 멈춤
+    uint32_t slot = 0;    // 역참조 (swap-remove 때 갱신)
+};
+
+// 애니메이션 상태 풀. 상태는 빈틈 없이 모아 두고 슬롯 + 세대 핸들로 가리킵니다.
+class AnimPool {
+public:
+    AnimHandle Create(const SpriteSheet* sheet, int tag);
+    void Destroy(AnimHandle h);
+    AnimState* Get(AnimHandle h);
+
+    // tag부터 처음부터 재생. repeat < 0 이면 태그의 repeat 값을 씁니다.
+    static void Play(AnimState& a, int tag, int repeat = -1);
+    void Update(float dtms);
+    size_t Count() const { return anims.size(); }
+
+private:
+    std::vector<AnimState> anims;       // 살아 있는 상태 (dense)
+    std::vector<uint32_t> denseIndex;   // 슬롯 -> anims 인덱스
+    std::vector<uint32_t> generations;  // 슬롯 세대
+    std::vector<uint32_t> freeSlots;
+};
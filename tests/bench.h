@@ -0,0 +1,19 @@
+#pragma once
+#include <chrono>
+#include <cstring>
+
+// 벤치마크 공용 도우미
+// --quick 인자를 주면 ctest에서 돌릴 수 있도록 작은 크기로만 실행합니다.
+inline bool BenchQuick(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) return true;
+    }
+    return false;
+}
+
+template <class F>
+double BenchMs(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -0,0 +1,58 @@
+#include "hit_index.h"
+#include "bench.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// 마우스 이벤트 라우팅 벤치마크: HitIndex vs 모든 위젯 선형 검사
+// (인덱스 전에는 스크립트가 위젯 목록을 z 역순으로 돌며 사각형을 검사했음)
+int main(int argc, char** argv) {
+    const bool quick = BenchQuick(argc, argv);
+    const int widgetCounts[] = { 100, 1000, 10000 };
+    const int queries = quick ? 2000 : 200000;
+
+    struct Rect { float x, y, w, h; int z; };
+    for (int n : widgetCounts) {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> pos(0.0f, 1920.0f), size(8.0f, 160.0f);
+
+        std::vector<Rect> rects(n);
+        HitIndex idx;
+        double buildMs = BenchMs([&] {
+            for (int i = 0; i < n; i++) {
+                float w = size(rng), h = size(rng);
+                if (i % 100 == 0) w = h = 1200.0f; // 배경 패널
+                rects[i] = { pos(rng), pos(rng), w, h, (int)(rng() % 4) };
+                idx.Set(i, rects[i].x, rects[i].y, w, h, rects[i].z);
+            }
+        });
+
+        std::vector<std::pair<float, float>> points(queries);
+        for (auto& p : points) p = { pos(rng), pos(rng) };
+
+        long long sinkIndex = 0, sinkLinear = 0;
+        double indexMs = BenchMs([&] {
+            for (auto [x, y] : points) {
+                int id;
+                if (idx.Hit(x, y, id)) sinkIndex += id;
+            }
+        });
+        double linearMs = BenchMs([&] {
+            for (auto [x, y] : points) {
+                int best = -1;
+                for (int i = 0; i < n; i++) {
+                    const Rect& r = rects[i];
+                    if (x < r.x || x >= r.x + r.w || y < r.y || y >= r.y + r.h) continue;
+                    if (best < 0 || r.z >= rects[best].z) best = i;
+                }
+                if (best >= 0) sinkLinear += best;
+            }
+        });
+
+        std::printf("%6d widgets: build %7.3f ms, index %7.3f us/query, linear %8.3f us/query (x%.1f)%s\n",
+            n, buildMs, indexMs * 1000.0 / queries, linearMs * 1000.0 / queries, linearMs / indexMs,
+            sinkIndex == sinkLinear ? "" : " MISMATCH");
+        if (sinkIndex != sinkLinear) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "lua_alloc.h"
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#if defined(TODOKI_HAVE_LUA)
+#include <lua.hpp>
+#endif
+
+// Lua 기본 할당기(lauxlib의 l_alloc)와 같은 동작
+static void* DefaultAlloc(void*, void* ptr, size_t, size_t nsize) {
+    if (nsize == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    return realloc(ptr, nsize);
+}
+
+// 1. 할당기만 따로: Lua 힙과 비슷한 크기 분포로 할당/재할당/해제를 섞어서 돌림
+//    (작은 문자열/테이블/클로저가 대부분, 가끔 배열 부분이 두 배로 커지는 재할당)
+
+struct Block { void* p; size_t n; };
+
+static double RunTrace(void* (*alloc)(void*, void*, size_t, size_t), void* ud, int ops, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Block> live;
+    live.reserve(ops);
+    return BenchMs([&] {
+        for (int i = 0; i < ops; i++) {
+            const uint32_t r = rng() % 100;
+            if (r < 55 || live.empty()) {
+                const uint32_t k = rng() % 100;
+                size_t n = k < 70 ? 16 + rng() % 48 : k < 95 ? 64 + rng() % 192 : 256 + rng() % 4096;
+                live.push_back({ alloc(ud, nullptr, 4, n), n });
+            }
+            else if (r < 65) {
+                Block& b = live[rng() % live.size()];
+                size_t n = b.n * 2;
+                b.p = alloc(ud, b.p, b.n, n);
+                b.n = n;
+            }
+            else {
+                size_t k = rng() % live.size();
+                alloc(ud, live[k].p, live[k].n, 0);
+                live[k] = live.back();
+                live.pop_back();
+            }
+        }
+        for (Block& b : live) alloc(ud, b.p, b.n, 0);
+    });
+}
+
+#if defined(TODOKI_HAVE_LUA)
+// 2. 실제 Lua 작업: 프레임마다 임시 테이블/문자열/클로저를 만드는 스크립트
+static const char* kScript = R"(
+local frames = ...
+local acc = 0
+for f = 1, frames do
+  local items = {}
+  for i = 1, 200 do
+    local v = { x = i, y = f, name = "item" .. i }
+    v.pos = function() return v.x + v.y end
+    items[#items + 1] = v
+  end
+  for _, v in ipairs(items) do acc = acc + v.pos() + #v.name end
+end
+return acc
+)";
+
+static double RunLua(lua_State* L, int frames) {
+    luaL_openlibs(L);
+    double ms = BenchMs([&] {
+        luaL_loadstring(L, kScript);
+        lua_pushinteger(L, frames);
+        if (lua_pcall(L, 1, 1, 0) != LUA_OK) std::printf("lua error: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    });
+    lua_close(L);
+    return ms;
+}
+#endif
+
+int main(int argc, char** argv) {
+    const bool quick = BenchQuick(argc, argv);
+    const int ops = quick ? 20000 : 5000000;
+
+    const double defMs = RunTrace(&DefaultAlloc, nullptr, ops, 7);
+    double poolMs;
+    {
+        LuaPoolAllocator pool;
+        poolMs = RunTrace(&LuaPoolAllocator::Alloc, &pool, ops, 7);
+    }
+    std::printf("alloc trace (%d ops): default %.2f ms, pool %.2f ms (x%.2f)\n",
+        ops, defMs, poolMs, defMs / poolMs);
+
+#if defined(TODOKI_HAVE_LUA)
+    const int frames = quick ? 20 : 3000;
+    const double luaDef = RunLua(lua_newstate(&DefaultAlloc, nullptr), frames);
+    LuaPoolAllocator pool;
+    const double luaPool = RunLua(lua_newstate(&LuaPoolAllocator::Alloc, &pool), frames);
+    std::printf("lua workload (%d frames): default %.2f ms, pool %.2f ms (x%.2f)\n",
+        frames, luaDef, luaPool, luaDef / luaPool);
+#endif
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "nav_grid.h"
+#include "bench.h"
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// 헤드리스 큰 맵 길찾기 벤치마크
+// 16칸마다 가로 벽(틈 몇 개)과 15% 무작위 장애물로 미로 비슷한 맵을 만들고
+// 스냅샷, 모서리-모서리 A*, 중앙 목표 흐름장, 중거리 질의 64개(1 스레드 / 작업 스레드 4개)를 잽니다.
+static void BuildMaze(NavGrid& grid, std::mt19937& rng) {
+    const int w = grid.Width(), h = grid.Height();
+    for (int y = 8; y < h; y += 16) {
+        grid.Fill(0, y, w, 1, true);
+        for (int k = 0; k < 8; k++) grid.Fill((int)(rng() % w), y, 4, 1, false);
+        grid.Set(1, y, false); // 모서리-모서리 경로가 항상 있도록 왼쪽 틈 하나
+    }
+    for (int y = 0; y < h; y++) {
+        if (y % 16 == 7 || y % 16 == 9) continue; // 벽 양옆 통로
+        for (int x = 0; x < w; x++) {
+            if (x != 1 && x != w - 2 && rng() % 100 < 15) grid.Set(x, y, true);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool quick = BenchQuick(argc, argv);
+    std::vector<int> sizes = quick ? std::vector<int>{ 256 } : std::vector<int>{ 1024, 2048, 4096 };
+
+    for (int size : sizes) {
+        std::mt19937 rng(1);
+        NavGrid grid(size, size);
+        const double buildMs = BenchMs([&] { BuildMaze(grid, rng); });
+
+        std::shared_ptr<const NavSnapshot> snap;
+        const double snapMs = BenchMs([&] { snap = grid.Snapshot(); });
+        grid.Set(5, 5, true);
+        const double snapEditMs = BenchMs([&] { snap = grid.Snapshot(); }); // 청크 하나만 복사됨
+
+        NavPath path;
+        const double coldMs = BenchMs([&] { path = FindNavPath(*snap, 1, 1, size - 2, size - 2, true); });
+        const double warmMs = BenchMs([&] { path = FindNavPath(*snap, 1, 1, size - 2, size - 2, true); });
+        bool current = false;
+        const double depsMs = BenchMs([&] { current = grid.IsCurrent(path.deps); });
+
+        NavFlowField field;
+        const double flowMs = BenchMs([&] { field = BuildNavFlowField(*snap, size / 2, size / 2, true); });
+
+        std::vector<std::array<int, 4>> queries;
+        while (queries.size() < 64) {
+            const int sx = (int)(rng() % size), sy = (int)(rng() % size);
+            const int tx = (sx + (int)(rng() % 200)) % size, ty = (sy + (int)(rng() % 200)) % size;
+            if (!snap->Blocked(sx, sy) && !snap->Blocked(tx, ty)) queries.push_back({ sx, sy, tx, ty });
+        }
+        int reachable = 0;
+        const double singleMs = BenchMs([&] {
+            for (auto& q : queries) reachable += FindNavPath(*snap, q[0], q[1], q[2], q[3], true).found;
+        });
+        NavWorkers workers(4);
+        std::atomic<int> done{ 0 };
+        const double workersMs = BenchMs([&] {
+            for (auto& q : queries) {
+                workers.Submit([&snap, &done, q] {
+                    FindNavPath(*snap, q[0], q[1], q[2], q[3], true);
+                    done++;
+                    });
+            }
+            while (done < (int)queries.size()) std::this_thread::yield();
+        });
+        workers.Stop();
+
+        std::printf("%dx%d (%zu chunks): build %.1f ms, snapshot %.3f ms (after edit %.3f ms)\n",
+            size, size, snap->ChunkCount(), buildMs, snapMs, snapEditMs);
+        std::printf("  A* corner-to-corner: found=%d len=%zu expanded=%u cold %.2f ms warm %.2f ms, deps %zu chunks (check %.3f ms, %s)\n",
+            (int)path.found, path.points.size() / 2, path.expanded, coldMs, warmMs, path.deps.chunks.size(), depsMs,
+            current ? "current" : "stale");
+        std::printf("  flow field %zu cells: %.2f ms\n", field.dist.size(), flowMs);
+        std::printf("  64 queries (<=200 cells apart, %d reachable): 1 thread %.2f ms, 4 workers %.2f ms\n",
+            reachable, singleMs, workersMs);
+        if (!path.found) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "particles.h"
+#include "bench.h"
+#include <cstdio>
+
+// 파티클 Update 커널 벤치마크
+// 같은 소스를 PARTICLE_SIMD_WIDTH=1 / 기본 / -mavx로 빌드한 실행 파일끼리 비교합니다.
+int main(int argc, char** argv) {
+#if defined(__AVX__) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx")) {
+        std::printf("bench_particles: AVX not supported on this CPU, skipped\n");
+        return 0;
+    }
+#endif
+    const bool quick = BenchQuick(argc, argv);
+    const uint32_t counts[] = { 1000, 10000, 100000 };
+    const int frames = quick ? 10 : 1000;
+
+    std::printf("simd width %d\n", ParticleSimdWidth());
+    for (uint32_t n : counts) {
+        if (quick && n > 10000) break;
+
+        ParticleEmitter e;
+        e.Seed(1);
+        e.maxCount = n;
+        e.lifeMin = e.lifeMax = 1e6f; // 측정 중에는 죽지 않게
+        e.speedMin = 10.0f;
+        e.speedMax = 100.0f;
+        e.gravityY = 98.0f;
+        e.drag = 0.1f;
+        e.Emit(n);
+
+        double ms = BenchMs([&] {
+            for (int f = 0; f < frames; f++) e.Update(1.0f / 60.0f);
+        });
+        std::printf("  %6u particles: %8.3f ms/frame, %6.2f ns/particle\n",
+            n, ms / frames, ms * 1e6 / ((double)frames * n));
+    }
+    return 0;
+}
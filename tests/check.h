@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// 테스트용 최소 단언 매크로 (외부 프레임워크 없이 CTest 종료 코드로 판정)
+inline int g_checkFailures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_checkFailures++;                                                   \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps)                                                    \
+    do {                                                                         \
+        double _a = (double)(a), _b = (double)(b);                              \
+        if (!(_a - _b <= (eps) && _b - _a <= (eps))) {                          \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", \
+                __FILE__, __LINE__, #a, #b, _a, _b);                             \
+            g_checkFailures++;                                                   \
+        }                                                                        \
+    } while (0)
+
+inline int CheckResult(const char* name) {
+    if (g_checkFailures == 0) {
+        std::printf("%s: ok\n", name);
+        return EXIT_SUCCESS;
+    }
+    std::fprintf(stderr, "%s: %d failure(s)\n", name, g_checkFailures);
+    return EXIT_FAILURE;
+}
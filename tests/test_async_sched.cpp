@@ -0,0 +1,257 @@
+#include "async_sched.h"
+#include "check.h"
+#include <lua.hpp>
+#include <cstring>
+#include <thread>
+
+// 엔진의 sys.async / sys.cancel / sys.sleep / sys.nextFrame 과 같은 바인딩을 붙인 헤드리스 상태
+static AsyncScheduler g_sched;
+
+// task:await() 대신 쓰는 테스트용 대상: open이 되면 value를 돌려줌
+struct Gate : AsyncWaitable {
+    bool open = false;
+    lua_Integer value = 0;
+    bool Ready(lua_State*) override { return open; }
+    void PushResult(lua_State* L) override { lua_pushinteger(L, value); }
+};
+static std::shared_ptr<Gate> g_gates[4];
+
+static int l_async(lua_State* L) { return g_sched.Spawn(L); }
+static int l_cancel(lua_State* L) { return g_sched.Cancel(L, 1); }
+static int l_sleep(lua_State* L) { return g_sched.Sleep(L, luaL_checknumber(L, 1)); }
+static int l_next_frame(lua_State* L) { return g_sched.NextFrame(L); }
+static int l_await_gate(lua_State* L) { return g_sched.Await(L, *g_gates[luaL_checkinteger(L, 1)]); }
+
+static lua_State* NewState() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    lua_newtable(L);
+    const luaL_Reg fns[] = {
+        { "async", l_async }, { "cancel", l_cancel }, { "sleep", l_sleep }, { "nextFrame", l_next_frame },
+    };
+    for (const auto& f : fns) {
+        lua_pushcfunction(L, f.func);
+        lua_setfield(L, -2, f.name);
+    }
+    lua_setglobal(L, "sys");
+    lua_register(L, "await_gate", l_await_gate);
+    for (auto& g : g_gates) g = std::make_shared<Gate>();
+    return L;
+}
+
+static void CloseState(lua_State* L) {
+    g_sched.Reset();
+    lua_close(L);
+}
+
+static void Run(lua_State* L, const char* code) {
+    if (luaL_dostring(L, code) != LUA_OK) {
+        std::fprintf(stderr, "lua error: %s\n", lua_tostring(L, -1));
+        g_checkFailures++;
+        lua_pop(L, 1);
+    }
+}
+
+static bool Eval(lua_State* L, const char* expr) {
+    lua_pushfstring(L, "return %s", expr);
+    luaL_loadstring(L, lua_tostring(L, -1));
+    lua_call(L, 0, 1);
+    bool v = lua_toboolean(L, -1);
+    lua_pop(L, 2);
+    return v;
+}
+
+static void FullGc(lua_State* L) {
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+}
+
+// 1. 부모 코루틴이 먼저 끝나서 수거된 뒤에도 자식은 살아서 재개됨
+static void TestNestedOutlivesParent() {
+    lua_State* L = NewState();
+    Run(L, R"(
+        log = {}
+        for i = 1, 20 do
+            sys.async(function()
+                sys.async(function()
+                    sys.sleep(100)
+                    log[#log + 1] = "child"
+                    sys.async(function() sys.nextFrame() log[#log + 1] = "grandchild" end)
+                end)
+                log[#log + 1] = "parent"
+            end)
+        end
+    )");
+    CHECK(g_sched.Count() == 20);
+    CHECK(Eval(L, "#log == 20"));
+
+    FullGc(L); // 부모 코루틴 20개는 참조가 없어져 수거됨
+    g_sched.Tick(50.0);
+    FullGc(L);
+    CHECK(Eval(L, "#log == 20"));
+    g_sched.Tick(70.0); // 100ms는 16ms 틱으로 올림되어 112ms에 깨어남
+    CHECK(Eval(L, "#log == 40 and log[40] == 'child'"));
+    CHECK(g_sched.Count() == 20); // 손자 코루틴들
+    FullGc(L);
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "#log == 60 and log[60] == 'grandchild'"));
+    CHECK(g_sched.Count() == 0);
+    CloseState(L);
+}
+
+// 2. await: 다른 스레드의 통지로 깨어나고, 대기자 모두가 같은 결과를 받음
+static void TestAwait() {
+    lua_State* L = NewState();
+    Run(L, R"(
+        sys.async(function() a = await_gate(1) end)
+        sys.async(function() b = await_gate(1) * 2 end)
+        sys.async(function() c = await_gate(2) end)
+    )");
+    CHECK(g_sched.AwaitingCount() == 3);
+
+    g_sched.Tick(16.0); // 통지 전에는 그대로
+    CHECK(g_sched.AwaitingCount() == 3);
+
+    g_gates[1]->value = 21;
+    g_gates[1]->open = true;
+    std::thread worker([] { g_sched.Notify(g_gates[1]); });
+    worker.join();
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "a == 21 and b == 42 and c == nil"));
+    CHECK(g_sched.AwaitingCount() == 1);
+
+    // 이미 끝난 대상은 sys.async 밖에서도 양보 없이 바로 결과
+    Run(L, "d = await_gate(1)");
+    CHECK(Eval(L, "d == 21"));
+    // 끝나지 않은 대상을 sys.async 밖에서 기다리면 에러
+    Run(L, "ok, err = pcall(await_gate, 3)");
+    CHECK(Eval(L, "ok == false and err:find('inside sys.async') ~= nil"));
+
+    // 기다리던 대상이 사라지면 대기 코루틴은 통지 없이 남음 (취소는 가능)
+    g_gates[2].reset();
+    CHECK(g_sched.AwaitingCount() == 0);
+    CHECK(g_sched.Count() == 1);
+    CloseState(L);
+}
+
+// 3. 취소: 대기 중이면 즉시 닫고(<close> 실행), 실행 중이면 다음 양보에서 닫음
+static void TestCancel() {
+    lua_State* L = NewState();
+    Run(L, R"(
+        closed = false
+        sleeper = sys.async(function()
+            local guard <close> = setmetatable({}, { __close = function() closed = true end })
+            sys.sleep(100)
+            reached = true
+        end)
+        waiter = sys.async(function() await_gate(1) waiterReached = true end)
+        framer = sys.async(function() sys.nextFrame() framerReached = true end)
+        r1 = sys.cancel(sleeper)
+        r2 = sys.cancel(sleeper)
+        r3 = sys.cancel(waiter)
+        r4 = sys.cancel(framer)
+        r5 = sys.cancel(coroutine.create(function() end))
+    )");
+    CHECK(Eval(L, "r1 == true and r2 == false and r3 == true and r4 == true and r5 == false"));
+    CHECK(Eval(L, "closed == true"));
+    CHECK(g_sched.Count() == 0);
+    CHECK(g_sched.AwaitingCount() == 0);
+
+    // 남은 핸들(nextFrame, 타이머 휠)은 새 코루틴과 섞이지 않고 버려짐
+    Run(L, "sys.async(function() sys.nextFrame() fresh = true end)");
+    g_gates[1]->open = true;
+    g_sched.Notify(g_gates[1]);
+    for (int i = 0; i < 10; i++) g_sched.Tick(16.0);
+    CHECK(Eval(L, "reached == nil and waiterReached == nil and framerReached == nil and fresh == true"));
+
+    // 자기 자신 취소: 계속 실행하다가 다음 양보에서 닫힘
+    Run(L, R"(
+        sys.async(function()
+            selfResult = sys.cancel(coroutine.running())
+            afterSelf = true
+            sys.nextFrame()
+            neverSelf = true
+        end)
+    )");
+    CHECK(Eval(L, "selfResult == true and afterSelf == true"));
+    CHECK(g_sched.Count() == 0);
+
+    // 중첩 sys.async 안에서 부모 취소: 부모는 자식이 돌려준 뒤 다음 양보에서 닫힘
+    Run(L, R"(
+        sys.async(function()
+            local parent = coroutine.running()
+            sys.async(function() sys.cancel(parent) sys.nextFrame() childAfter = true end)
+            parentAfter = true
+            sys.sleep(10)
+            parentNever = true
+        end)
+    )");
+    CHECK(g_sched.Count() == 1);
+    g_sched.Tick(16.0);
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "parentAfter == true and parentNever == nil and childAfter == true"));
+    CHECK(g_sched.Count() == 0);
+    CloseState(L);
+}
+
+// 4. 타이머: 휠 한 바퀴(약 4초)보다 긴 대기도 일찍 깨지 않음, 에러난 코루틴은 정리됨
+static void TestTimersAndErrors() {
+    lua_State* L = NewState();
+    Run(L, R"(
+        sys.async(function() sys.sleep(5000) woke = true end)
+        sys.async(function() sys.sleep(0) zero = true end)
+        sys.async(function() coroutine.yield() yielded = true end)
+        sys.async(function() sys.nextFrame() error("boom") end)
+    )");
+    CHECK(g_sched.Count() == 4);
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "zero == true and yielded == true and woke == nil"));
+    CHECK(g_sched.Count() == 1);
+
+    double t = 16.0;
+    while (t + 16.0 < 5000.0) {
+        g_sched.Tick(16.0);
+        t += 16.0;
+    }
+    CHECK(Eval(L, "woke == nil"));
+    g_sched.Tick(32.0);
+    CHECK(Eval(L, "woke == true"));
+    CHECK(g_sched.Count() == 0);
+
+    Run(L, "ok, err = pcall(sys.sleep, 10)");
+    CHECK(Eval(L, "ok == false and err:find('inside sys.async') ~= nil"));
+    CloseState(L);
+}
+
+// 5. 통지로 깨어난 코루틴이 같은 Tick 안에서 다시 양보하면 다음 Tick에 이어서 실행
+static void TestWokenYieldWaitsForNextTick() {
+    lua_State* L = NewState();
+    Run(L, R"(
+        steps = { 0, 0, 0 }
+        sys.async(function() await_gate(1) steps[1] = 1 sys.nextFrame() steps[1] = 2 end)
+        sys.async(function() await_gate(1) steps[2] = 1 coroutine.yield() steps[2] = 2 end)
+        sys.async(function() await_gate(1) steps[3] = 1 sys.sleep(0) steps[3] = 2 end)
+    )");
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "steps[1] == 0 and steps[2] == 0 and steps[3] == 0"));
+
+    g_gates[1]->open = true;
+    g_sched.Notify(g_gates[1]);
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "steps[1] == 1 and steps[2] == 1 and steps[3] == 1"));
+    CHECK(g_sched.Count() == 3);
+
+    g_sched.Tick(16.0);
+    CHECK(Eval(L, "steps[1] == 2 and steps[2] == 2 and steps[3] == 2"));
+    CHECK(g_sched.Count() == 0);
+    CloseState(L);
+}
+
+int main() {
+    TestNestedOutlivesParent();
+    TestAwait();
+    TestCancel();
+    TestTimersAndErrors();
+    TestWokenYieldWaitsForNextTick();
+    return CheckResult("test_async_sched");
+}
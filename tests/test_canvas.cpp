@@ -0,0 +1,153 @@
+#include "canvas.h"
+#include "check.h"
+
+// 엔진(lua_g.cpp)처럼 대상마다 하나씩 있는 그리기 상태
+struct FakeDrawState {
+    float tx = 0.0f;
+    std::vector<int> clips;
+};
+
+// 엔진과 같은 방식으로 훅 연결: 전환할 때 그리기 상태를 보관/복원하고 현재 대상을 바꿈
+struct Engine {
+    SoftwareCanvasBackend backend;
+    CanvasStateSwap<FakeDrawState> mainDraw;
+    FakeDrawState draw;
+    SoftwareCanvasSurface* target = nullptr; // nullptr이면 화면
+    int clipsPoppedOnEnd = 0;
+    CanvasSet canvases{ backend }; // 정리할 때 훅이 위 상태를 쓰므로 마지막에 선언
+
+    Engine() {
+        canvases.onBegin = [this](Canvas& c) {
+            mainDraw.Enter(draw);
+            target = static_cast<SoftwareCanvasSurface*>(c.surface.get());
+            };
+        canvases.onEnd = [this](Canvas&) {
+            clipsPoppedOnEnd += (int)draw.clips.size();
+            target = nullptr;
+            mainDraw.Leave(draw);
+            };
+    }
+};
+
+static SoftwareCanvasSurface* SurfaceOf(Canvas& c) {
+    return static_cast<SoftwareCanvasSurface*>(c.surface.get());
+}
+
+// 1. 대상 전환과 상태 보관: 캔버스 안의 변환/클립은 메인 상태와 섞이지 않음
+static void TestTargetAndStateSwap() {
+    Engine e;
+    auto a = e.canvases.Create(8, 4, 3);
+    auto b = e.canvases.Create(0, -1, 4);
+    CHECK(a->width == 8 && a->height == 4 && a->imageId == 3);
+    CHECK(b->width == 1 && b->height == 1); // 최소 1x1
+    CHECK(e.canvases.Count() == 2 && e.backend.created == 0); // 렌더 타깃은 처음 Begin 때
+
+    e.draw.tx = 5.0f;
+    e.draw.clips = { 1 };
+    CHECK(e.canvases.Begin(*a));
+    CHECK(e.canvases.Active() == a.get() && e.target == SurfaceOf(*a));
+    CHECK(e.target->drawing);
+    CHECK(e.draw.tx == 0.0f && e.draw.clips.empty()); // 캔버스는 빈 상태에서 시작
+    e.draw.tx = 9.0f;
+    e.draw.clips = { 7, 8 };
+    e.target->Clear(0xff000000);
+    e.target->FillRect(6, 2, 10, 10, 0xffff0000); // 밖으로 나간 부분은 잘림
+    CHECK(SurfaceOf(*a)->Pixel(7, 3) == 0xffff0000);
+    CHECK(SurfaceOf(*a)->Pixel(5, 3) == 0xff000000);
+
+    // 다른 캔버스로 바로 전환: 앞 캔버스를 끝내고 메인 상태는 그대로 보관
+    CHECK(e.canvases.Begin(*b));
+    CHECK(!SurfaceOf(*a)->drawing);
+    CHECK(e.clipsPoppedOnEnd == 2);
+    CHECK(e.canvases.Active() == b.get() && e.target == SurfaceOf(*b));
+    CHECK(e.draw.tx == 0.0f && e.draw.clips.empty());
+
+    e.canvases.End();
+    CHECK(e.canvases.Active() == nullptr && e.target == nullptr);
+    CHECK(e.draw.tx == 5.0f && e.draw.clips.size() == 1 && e.draw.clips[0] == 1);
+    e.canvases.End(); // 화면에 그리는 중이면 아무것도 안 함
+    CHECK(e.draw.tx == 5.0f && e.clipsPoppedOnEnd == 2);
+
+    // 그리는 중에 캔버스가 사라지면 먼저 끝내고 목록에서 빠짐
+    CHECK(e.canvases.Begin(*a));
+    a.reset();
+    CHECK(e.canvases.Active() == nullptr && e.target == nullptr);
+    CHECK(e.draw.tx == 5.0f);
+    CHECK(e.canvases.Count() == 1 && e.canvases.All()[0] == b.get());
+
+    // 다른 세트의 캔버스는 받지 않음
+    Engine other;
+    auto foreign = other.canvases.Create(2, 2, 0);
+    CHECK(!e.canvases.Begin(*foreign));
+    CHECK(e.canvases.Active() == nullptr && !foreign->surface);
+}
+
+// 2. dirty: 새 타깃이면 Begin에서 지우고, 디바이스 손실/EndDraw 실패 뒤에는 다시 켜짐
+static void TestDirtyAfterDeviceLoss() {
+    Engine e;
+    auto c = e.canvases.Create(4, 4, 0);
+    CHECK(c->dirty);
+    CHECK(e.canvases.Begin(*c));
+    CHECK(!c->dirty);
+    e.canvases.End();
+    CHECK(!c->dirty && e.backend.created == 1);
+
+    // 스크립트가 직접 켜는 경우: 타깃은 그대로 쓰고 Begin에서 꺼짐
+    c->dirty = true;
+    CHECK(e.canvases.Begin(*c));
+    CHECK(!c->dirty && e.backend.created == 1);
+
+    // 그리는 도중 디바이스 손실: 먼저 끝내고 타깃을 버림
+    e.draw.tx = 3.0f;
+    e.canvases.DeviceLost();
+    CHECK(e.canvases.Active() == nullptr && e.target == nullptr);
+    CHECK(e.draw.tx == 0.0f); // 메인 상태로 복귀
+    CHECK(c->dirty && !c->surface);
+
+    CHECK(e.canvases.Begin(*c));
+    CHECK(e.backend.created == 2 && !c->dirty);
+
+    // EndDraw가 내용을 잃었다고 하면 dirty
+    SurfaceOf(*c)->lost = true;
+    e.canvases.End();
+    CHECK(c->dirty);
+}
+
+// 3. 메모리 계산: 렌더 타깃이 있는 캔버스만 BGRA 4바이트로 셈
+static void TestBytes() {
+    Engine e;
+    auto a = e.canvases.Create(16, 8, 0);
+    auto b = e.canvases.Create(4, 4, 1);
+    CHECK(e.canvases.Bytes() == 0);
+
+    e.canvases.Begin(*a);
+    e.canvases.End();
+    CHECK(e.canvases.Bytes() == 16 * 8 * 4);
+    e.canvases.Begin(*b);
+    CHECK(e.canvases.Bytes() == (16 * 8 + 4 * 4) * 4);
+
+    b.reset();
+    CHECK(e.canvases.Bytes() == 16 * 8 * 4 && e.canvases.Count() == 1);
+    e.canvases.DeviceLost();
+    CHECK(e.canvases.Bytes() == 0 && e.canvases.Count() == 1);
+}
+
+// 4. 세트가 먼저 사라져도 남은 캔버스는 안전하게 정리됨 (엔진 종료 순서)
+static void TestSetOutlivedByCanvas() {
+    std::shared_ptr<Canvas> c;
+    {
+        Engine e;
+        c = e.canvases.Create(2, 2, 0);
+        e.canvases.Begin(*c);
+    }
+    CHECK(c->owner == nullptr && !c->surface);
+    c.reset();
+}
+
+int main() {
+    TestTargetAndStateSwap();
+    TestDirtyAfterDeviceLoss();
+    TestBytes();
+    TestSetOutlivedByCanvas();
+    return CheckResult("test_canvas");
+}
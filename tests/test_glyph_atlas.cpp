@@ -0,0 +1,164 @@
+#include "glyph_atlas.h"
+#include "check.h"
+#include <string>
+#include <vector>
+
+struct Rect { int x, y, w, h; };
+
+static bool Overlaps(const Rect& a, const Rect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// 1. shelf 패킹: 겹치지 않고, 높이가 맞는 가장 낮은 shelf를 재사용
+static void TestShelfPacking() {
+    GlyphAtlas atlas(64, 64);
+    std::vector<uint8_t> alpha(16 * 16, 0xAB);
+    std::vector<Rect> placed;
+    int x, y;
+
+    // 높이 10(+여백 1)짜리 shelf를 가로로 채움: 64 / 11 = 5개
+    for (int i = 0; i < 5; i++) {
+        CHECK(atlas.Insert(10, 10, alpha.data(), x, y));
+        CHECK(y == 0);
+        CHECK(x == i * 11);
+        placed.push_back({ x, y, 11, 11 });
+    }
+    // 6번째는 새 shelf로
+    CHECK(atlas.Insert(10, 10, alpha.data(), x, y));
+    CHECK(x == 0 && y == 11);
+    placed.push_back({ x, y, 11, 11 });
+
+    // 더 높은 글리프는 새 shelf, 낮은 글리프는 남는 자리가 있는 기존 shelf로
+    CHECK(atlas.Insert(4, 15, alpha.data(), x, y));
+    CHECK(x == 0 && y == 22);
+    placed.push_back({ x, y, 5, 16 });
+    CHECK(atlas.Insert(4, 4, alpha.data(), x, y));
+    CHECK(x == 55 && y == 0); // 높이 11 shelf가 높이 16 shelf보다 낮으므로 우선
+    placed.push_back({ x, y, 5, 5 });
+
+    for (size_t i = 0; i < placed.size(); i++) {
+        for (size_t j = i + 1; j < placed.size(); j++) CHECK(!Overlaps(placed[i], placed[j]));
+    }
+
+    // 픽셀 복사와 1px 여백
+    const auto& px = atlas.Pixels();
+    CHECK(px[0] == 0xAB && px[9] == 0xAB);
+    CHECK(px[10] == 0);              // 여백 열
+    CHECK(px[(size_t)10 * 64] == 0); // 여백 행
+
+    // 더티 영역은 한 번 가져가면 비워짐
+    int x0, y0, x1, y1;
+    CHECK(atlas.TakeDirty(x0, y0, x1, y1));
+    CHECK(x0 == 0 && y0 == 0 && x1 == 59 && y1 == 37);
+    CHECK(!atlas.TakeDirty(x0, y0, x1, y1));
+
+    // 아틀라스보다 큰 글리프, 세로가 가득 찬 경우는 실패
+    CHECK(!atlas.Insert(64, 1, alpha.data(), x, y));
+    while (atlas.Insert(16, 16, alpha.data(), x, y)) {}
+    CHECK(!atlas.Insert(16, 16, alpha.data(), x, y));
+
+    const uint32_t gen = atlas.Generation();
+    atlas.Reset();
+    CHECK(atlas.Generation() == gen + 1);
+    CHECK(atlas.Insert(10, 10, alpha.data(), x, y));
+    CHECK(x == 0 && y == 0);
+}
+
+// 글리프마다 코드포인트 값으로 칠한 비트맵을 내는 가짜 래스터라이저
+struct FakeRasterizer {
+    int calls = 0;
+    int size = 10;
+    bool operator()(uint32_t cp, GlyphBitmap& out) {
+        calls++;
+        if (cp == 0x25A1) return false; // 폰트에 없는 글자
+        out.width = out.height = size;
+        out.offsetX = 0.0f;
+        out.offsetY = -(float)size;
+        out.advance = (float)size;
+        out.alpha.assign((size_t)size * size, (uint8_t)cp);
+        return true;
+    }
+};
+
+// 2. 가득 차면 아틀라스를 비우고(퇴출) 폰트 캐시도 다시 채움
+static void TestEviction() {
+    GlyphAtlas atlas(33, 33); // 10x10 글리프 9개까지 (여백 포함 11x11)
+    FakeRasterizer fr;
+    GlyphFont a(&atlas, [&](uint32_t cp, GlyphBitmap& out) { return fr(cp, out); }, nullptr, 12.0f, 10.0f);
+    GlyphFont b(&atlas, [&](uint32_t cp, GlyphBitmap& out) { return fr(cp, out); }, nullptr, 12.0f, 10.0f);
+
+    std::vector<GlyphQuad> quads;
+    float w, h;
+    CHECK(a.Layout("ABCDEFGHI", 0, 0, quads, w, h));
+    CHECK(quads.size() == 9);
+    CHECK(fr.calls == 9);
+    CHECK(atlas.Generation() == 0);
+
+    // 캐시된 글리프는 다시 래스터라이즈하지 않음
+    CHECK(a.Layout("IHG", 0, 0, quads, w, h));
+    CHECK(fr.calls == 9);
+
+    // 10번째 글자에서 아틀라스가 리셋되고, 레이아웃은 새 세대로 다시 돌아감
+    CHECK(a.Layout("AJ", 0, 0, quads, w, h));
+    CHECK(atlas.Generation() == 1);
+    CHECK(quads.size() == 2);
+    const auto& px = atlas.Pixels();
+    for (const auto& q : quads) {
+        CHECK(q.page == -1);
+        CHECK(px[(size_t)q.sy * atlas.Width() + q.sx] == (q.sx == quads[0].sx && q.sy == quads[0].sy ? 'A' : 'J'));
+    }
+
+    // 같은 아틀라스를 쓰는 다른 폰트도 세대가 바뀐 걸 보고 캐시를 버림
+    const int before = fr.calls;
+    CHECK(b.Layout("A", 0, 0, quads, w, h));
+    CHECK(fr.calls == before + 1);
+    CHECK(px[(size_t)quads[0].sy * atlas.Width() + quads[0].sx] == 'A');
+
+    // 한 문자열이 아틀라스보다 크면 실패
+    CHECK(!a.Layout("abcdefghijklmnopqrstuvwxyz", 0, 0, quads, w, h));
+
+    // 없는 글자는 온디맨드 폰트에서 false (DrawText 폴백)
+    CHECK(!a.Layout("A\xE2\x96\xA1", 0, 0, quads, w, h));
+}
+
+// 3. BMFont: 없는 글리프는 건너뛰고, 줄바꿈/커닝 반영
+static void TestBitmapFontLayout() {
+    GlyphFont f(20.0f, 16.0f);
+    GlyphInfo gi;
+    gi.w = gi.h = 8;
+    gi.advance = 9.0f;
+    gi.page = 3;
+    f.AddGlyph('a', gi);
+    gi.x = 8;
+    f.AddGlyph('b', gi);
+    f.AddKerning('a', 'b', -2.0f);
+
+    std::vector<GlyphQuad> quads;
+    float w, h;
+    CHECK(f.Layout("ab?\na", 10.0f, 0.0f, quads, w, h));
+    CHECK(quads.size() == 3);
+    CHECK_NEAR(quads[1].x, 10.0f + 9.0f - 2.0f, 1e-6);
+    CHECK(quads[1].sx == 8 && quads[1].page == 3);
+    CHECK_NEAR(quads[2].y, 20.0f + 16.0f, 1e-6);
+    CHECK_NEAR(w, 16.0f, 1e-6);
+    CHECK_NEAR(h, 40.0f, 1e-6);
+}
+
+static void TestUtf8() {
+    const std::string s = "A\xEA\xB0\x80\xF0\x9F\x98\x80\xC3";
+    const char* p = s.data();
+    const char* end = p + s.size();
+    CHECK(DecodeUtf8(p, end) == 'A');
+    CHECK(DecodeUtf8(p, end) == 0xAC00);
+    CHECK(DecodeUtf8(p, end) == 0x1F600);
+    CHECK(DecodeUtf8(p, end) == 0xFFFD); // 잘린 시퀀스
+    CHECK(p == end);
+}
+
+int main() {
+    TestShelfPacking();
+    TestEviction();
+    TestBitmapFontLayout();
+    TestUtf8();
+    return CheckResult("test_glyph_atlas");
+}
@@ -0,0 +1,128 @@
+#include "hit_index.h"
+#include "check.h"
+#include <random>
+#include <vector>
+
+static int HitId(const HitIndex& idx, float x, float y) {
+    int id = -1;
+    return idx.Hit(x, y, id) ? id : -1;
+}
+
+// 1. 경계, z 순서, 추가 순서, 이동/삭제
+static void TestBasics() {
+    HitIndex idx(32.0f);
+    idx.Set(1, 10, 10, 100, 50);
+    CHECK(HitId(idx, 10, 10) == 1);     // 왼쪽/위 경계 포함
+    CHECK(HitId(idx, 109.9f, 59.9f) == 1);
+    CHECK(HitId(idx, 110, 30) == -1);   // 오른쪽/아래 경계 제외
+    CHECK(HitId(idx, 50, 60) == -1);
+
+    // 같은 z면 나중에 추가한 것이 위, z가 높으면 순서와 관계없이 위
+    idx.Set(2, 50, 20, 20, 20);
+    CHECK(HitId(idx, 55, 25) == 2);
+    idx.Set(3, 40, 15, 40, 40, -1);
+    CHECK(HitId(idx, 55, 25) == 2);
+    CHECK(HitId(idx, 45, 17) == 1);
+    idx.Set(1, 10, 10, 100, 50, 5);     // 다시 Set 해도 추가 순서는 유지, z만 바뀜
+    CHECK(HitId(idx, 55, 25) == 1);
+    idx.Set(1, 10, 10, 100, 50, 0);
+    CHECK(HitId(idx, 55, 25) == 2);
+
+    // Move는 z를 유지
+    CHECK(idx.Move(3, 200, 200, 10, 10));
+    CHECK(HitId(idx, 205, 205) == 3);
+    CHECK(!idx.Move(99, 0, 0, 1, 1));
+
+    // 음수 크기는 반대 방향으로
+    idx.Set(4, 300, 300, -20, -20);
+    CHECK(HitId(idx, 290, 290) == 4);
+
+    CHECK(idx.Remove(2));
+    CHECK(!idx.Remove(2));
+    CHECK(HitId(idx, 55, 25) == 1);
+    CHECK(idx.Count() == 3);
+
+    // 삭제 후 다시 추가하면 맨 위 순서
+    idx.Set(2, 50, 20, 20, 20);
+    CHECK(HitId(idx, 55, 25) == 2);
+
+    idx.Clear();
+    CHECK(idx.Count() == 0);
+    CHECK(HitId(idx, 55, 25) == -1);
+}
+
+// 2. 칸을 많이 덮는 큰 사각형(격자 밖 목록)과 작은 사각형이 섞여도 순서가 맞음
+static void TestLargeRegions() {
+    HitIndex idx(16.0f);
+    idx.Set(1, 0, 0, 4000, 4000, 0);     // 배경 패널
+    idx.Set(2, 100, 100, 10, 10, 1);
+    idx.Set(3, 90, 90, 30, 30, 0);       // 같은 z, 배경보다 나중
+    CHECK(HitId(idx, 105, 105) == 2);
+    CHECK(HitId(idx, 95, 95) == 3);
+    CHECK(HitId(idx, 3000, 3000) == 1);
+
+    // 큰 사각형이 작아지면 격자로, 작은 것이 커지면 큰 목록으로 옮겨짐
+    idx.Set(1, 0, 0, 20, 20, 0);
+    CHECK(HitId(idx, 3000, 3000) == -1);
+    idx.Set(2, 0, 0, 5000, 5000, 1);
+    CHECK(HitId(idx, 3000, 3000) == 2);
+    CHECK(HitId(idx, 95, 95) == 2);
+
+    // 아주 큰 좌표, NaN에서도 넘치지 않음
+    idx.Set(4, -1e30f, -1e30f, 2e30f, 2e30f, -5);
+    CHECK(HitId(idx, -1e20f, 1e20f) == 4);
+    int id;
+    CHECK(!idx.Hit(std::nanf(""), 0.0f, id));
+}
+
+// 3. 무작위 추가/이동/삭제 후 선형 검사와 결과가 같음
+static void TestMatchesLinearScan() {
+    struct Ref { float x, y, w, h; int z; uint32_t order; bool alive; };
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-100.0f, 1500.0f), size(2.0f, 150.0f);
+
+    HitIndex idx(48.0f);
+    std::vector<Ref> ref(2000);
+    uint32_t order = 0;
+    for (int i = 0; i < (int)ref.size(); i++) {
+        float w = size(rng), h = size(rng);
+        if (i % 200 == 0) w = h = 2000.0f;
+        ref[i] = { pos(rng), pos(rng), w, h, (int)(rng() % 4), order++, true };
+        idx.Set(i, ref[i].x, ref[i].y, w, h, ref[i].z);
+    }
+    for (int k = 0; k < 3000; k++) {
+        int i = (int)(rng() % ref.size());
+        if (rng() % 4 == 0) {
+            idx.Remove(i);
+            ref[i].alive = false;
+            continue;
+        }
+        ref[i].x += size(rng) - 75.0f;
+        ref[i].y += size(rng) - 75.0f;
+        if (!ref[i].alive) {
+            ref[i].alive = true;
+            ref[i].order = order++;
+        }
+        idx.Set(i, ref[i].x, ref[i].y, ref[i].w, ref[i].h, ref[i].z);
+    }
+
+    int mismatches = 0;
+    for (int q = 0; q < 20000; q++) {
+        float x = pos(rng), y = pos(rng);
+        int best = -1;
+        for (int i = 0; i < (int)ref.size(); i++) {
+            const Ref& r = ref[i];
+            if (!r.alive || x < r.x || x >= r.x + r.w || y < r.y || y >= r.y + r.h) continue;
+            if (best < 0 || r.z > ref[best].z || (r.z == ref[best].z && r.order > ref[best].order)) best = i;
+        }
+        if (HitId(idx, x, y) != best) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+int main() {
+    TestBasics();
+    TestLargeRegions();
+    TestMatchesLinearScan();
+    return CheckResult("test_hit_index");
+}
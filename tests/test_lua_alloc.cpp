@@ -0,0 +1,283 @@
+#include "lua_alloc.h"
+#include "check.h"
+#if defined(TODOKI_HAVE_LUA)
+#include "gc_schedule.h"
+#endif
+#include <cstring>
+#include <vector>
+#if defined(TODOKI_HAVE_LUA)
+#include <lua.hpp>
+#endif
+
+static void* New(LuaPoolAllocator& a, size_t n) {
+    return LuaPoolAllocator::Alloc(&a, nullptr, 5 /* LUA_TTABLE: ptr이 NULL이면 osize는 종류 */, n);
+}
+
+static void Fill(void* p, size_t n, uint8_t seed) {
+    for (size_t i = 0; i < n; i++) ((uint8_t*)p)[i] = (uint8_t)(seed + i);
+}
+
+static bool Same(const void* p, size_t n, uint8_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        if (((const uint8_t*)p)[i] != (uint8_t)(seed + i)) return false;
+    }
+    return true;
+}
+
+// 1. 크기 클래스 간 재할당에서 내용 보존과 통계
+static void TestReallocPaths() {
+    LuaPoolAllocator a;
+    void* p = New(a, 40);
+    CHECK(p != nullptr);
+    CHECK(a.Stats().liveBytes == 40);
+    CHECK(a.Stats().totalAllocs == 1);
+    Fill(p, 40, 1);
+
+    // 같은 클래스(33~48)면 그대로
+    CHECK(LuaPoolAllocator::Alloc(&a, p, 40, 48) == p);
+
+    // 작은 -> 작은 (다른 클래스)
+    p = LuaPoolAllocator::Alloc(&a, p, 48, 200);
+    CHECK(Same(p, 40, 1));
+    Fill(p, 200, 2);
+
+    // 작은 -> 큰
+    p = LuaPoolAllocator::Alloc(&a, p, 200, 5000);
+    CHECK(Same(p, 200, 2));
+    Fill(p, 5000, 3);
+
+    // 큰 -> 큰, 큰 -> 작은
+    p = LuaPoolAllocator::Alloc(&a, p, 5000, 9000);
+    CHECK(Same(p, 5000, 3));
+    p = LuaPoolAllocator::Alloc(&a, p, 9000, 24);
+    CHECK(Same(p, 24, 3));
+    CHECK(a.Stats().liveBytes == 24);
+    CHECK(a.Stats().peakBytes == 9000);
+    CHECK(a.Stats().totalAllocs == 1); // 재할당은 새 할당으로 세지 않음
+
+    CHECK(LuaPoolAllocator::Alloc(&a, p, 24, 0) == nullptr);
+    CHECK(a.Stats().liveBytes == 0);
+}
+
+// 2. free-list 재사용과 풀 독립성
+static void TestFreeListsPerPool() {
+    LuaPoolAllocator a, b;
+    void* p = New(a, 32);
+    LuaPoolAllocator::Alloc(&a, p, 32, 0);
+    CHECK(New(a, 30) == p); // 같은 클래스는 방금 놓은 블록을 다시 씀
+    CHECK(New(b, 30) != p); // 다른 상태의 풀은 자기 슬랩에서
+
+    CHECK(a.Stats().reservedBytes == 64 * 1024);
+    CHECK(b.Stats().reservedBytes == 64 * 1024);
+    CHECK(a.Stats().liveBytes == 30);
+    CHECK(b.Stats().liveBytes == 30);
+
+    // 슬랩 여러 개에 걸쳐도 블록이 겹치지 않음
+    std::vector<void*> blocks;
+    for (int i = 0; i < 5000; i++) {
+        void* q = New(a, 64);
+        Fill(q, 64, (uint8_t)i);
+        blocks.push_back(q);
+    }
+    bool intact = true;
+    for (int i = 0; i < 5000; i++) intact &= Same(blocks[i], 64, (uint8_t)i);
+    CHECK(intact);
+    CHECK(a.Stats().reservedBytes > 64 * 1024);
+}
+
+// 3. 프레임 통계
+static void TestFrameStats() {
+    LuaPoolAllocator a;
+    void* p = New(a, 100);
+    p = LuaPoolAllocator::Alloc(&a, p, 100, 150);
+    a.EndFrame();
+    CHECK(a.Stats().frameAllocs == 1);
+    CHECK(a.Stats().frameBytes == 150);
+    a.EndFrame();
+    CHECK(a.Stats().frameAllocs == 0);
+    LuaPoolAllocator::Alloc(&a, p, 150, 0);
+}
+
+// 4. 풀이 모자랄 때 큰 블록 -> 작은 블록: malloc 블록을 그대로 쓰고 free-list에는 넣지 않음
+static void TestShrinkWhenPoolExhausted() {
+    LuaPoolAllocator a;
+    a.maxReservedBytes = 0; // 슬랩을 못 잡음
+    CHECK(New(a, 24) == nullptr);
+
+    void* big = New(a, 5000);
+    CHECK(big != nullptr);
+    Fill(big, 5000, 4);
+    void* p = LuaPoolAllocator::Alloc(&a, big, 5000, 24);
+    CHECK(p == big && Same(p, 24, 4));
+    CHECK(a.Stats().liveBytes == 24);
+
+    // 따로 둔 블록끼리의 재할당: 작게 -> 다시 크게
+    p = LuaPoolAllocator::Alloc(&a, p, 24, 40);
+    CHECK(p == big && Same(p, 24, 4));
+    p = LuaPoolAllocator::Alloc(&a, p, 40, 9000);
+    CHECK(p != nullptr && Same(p, 24, 4));
+    p = LuaPoolAllocator::Alloc(&a, p, 9000, 100);
+    CHECK(p != nullptr && Same(p, 24, 4));
+
+    // 해제는 free로: 풀이 다시 생겨도 이 블록을 작은 블록으로 내주지 않음
+    CHECK(LuaPoolAllocator::Alloc(&a, p, 100, 0) == nullptr);
+    CHECK(a.Stats().liveBytes == 0);
+    a.maxReservedBytes = SIZE_MAX;
+    void* q = New(a, 100);
+    CHECK(q != nullptr && q != p);
+    Fill(q, 100, 5);
+
+    // 풀이 생긴 뒤에는 따로 둔 블록도 다음 재할당 때 풀로 옮겨감
+    CHECK(Same(q, 100, 5));
+    LuaPoolAllocator::Alloc(&a, q, 100, 0);
+    CHECK(a.Stats().liveBytes == 0);
+
+    LuaPoolAllocator c;
+    c.maxReservedBytes = 0;
+    void* r = LuaPoolAllocator::Alloc(&c, New(c, 3000), 3000, 30);
+    Fill(r, 30, 6);
+    c.maxReservedBytes = SIZE_MAX;
+    void* moved = LuaPoolAllocator::Alloc(&c, r, 30, 20);
+    CHECK(moved != nullptr && moved != r && Same(moved, 20, 6));
+    LuaPoolAllocator::Alloc(&c, moved, 20, 0);
+    CHECK(New(c, 20) == moved); // 옮겨간 블록은 평소처럼 free-list로
+    LuaPoolAllocator::Alloc(&c, moved, 20, 0);
+    CHECK(c.Stats().liveBytes == 0);
+
+    // 기억할 칸이 다 차면 실패를 돌려주고 원래 블록은 그대로
+    LuaPoolAllocator b;
+    b.maxReservedBytes = 0;
+    std::vector<void*> loose;
+    void* last = nullptr;
+    for (int i = 0; i < 100; i++) {
+        void* blk = New(b, 1000);
+        void* s = LuaPoolAllocator::Alloc(&b, blk, 1000, 32);
+        if (!s) {
+            last = blk;
+            break;
+        }
+        loose.push_back(s);
+    }
+    CHECK(last != nullptr && !loose.empty());
+    CHECK(b.Stats().liveBytes == loose.size() * 32 + 1000);
+    LuaPoolAllocator::Alloc(&b, last, 1000, 0);
+    for (void* s : loose) LuaPoolAllocator::Alloc(&b, s, 32, 0);
+    CHECK(b.Stats().liveBytes == 0);
+}
+
+#if defined(TODOKI_HAVE_LUA)
+// 5. 실제 Lua 상태: 상태마다 자기 풀을 쓰고, 닫으면 모두 반환
+static void TestLuaStates() {
+    LuaPoolAllocator pa, pb;
+    lua_State* A = lua_newstate(&LuaPoolAllocator::Alloc, &pa);
+    lua_State* B = lua_newstate(&LuaPoolAllocator::Alloc, &pb);
+    luaL_openlibs(A);
+    luaL_openlibs(B);
+
+    const size_t before = pb.Stats().liveBytes;
+    CHECK(luaL_dostring(A,
+        "t = {} for i = 1, 20000 do t[i] = { i, tostring(i) } end "
+        "s = table.concat(t[1], ',') t[5] = nil") == LUA_OK);
+    CHECK(pa.Stats().liveBytes > 20000 * 32);
+    CHECK(pb.Stats().liveBytes == before); // B의 풀은 A의 할당을 보지 않음
+
+    void* ud = nullptr;
+    CHECK(lua_getallocf(A, &ud) == &LuaPoolAllocator::Alloc && ud == &pa);
+
+    lua_close(A);
+    lua_close(B);
+    CHECK(pa.Stats().liveBytes == 0);
+    CHECK(pb.Stats().liveBytes == 0);
+}
+
+// 호출할 때마다 정해진 만큼 흐르는 시계
+static double g_fakeNowMs = 0.0, g_fakeTickMs = 0.5;
+static double FakeNow() {
+    g_fakeNowMs += g_fakeTickMs;
+    return g_fakeNowMs;
+}
+
+static int HeapKB(lua_State* L) { return lua_gc(L, LUA_GCCOUNT); }
+
+// 약 n * 70바이트의 쓰레기를 만듦 (수집기가 멈춰 있으므로 그대로 남음)
+static void MakeGarbage(lua_State* L, int n) {
+    lua_pushinteger(L, n);
+    lua_setglobal(L, "N");
+    CHECK(luaL_dostring(L, "local t = {} for i = 1, N do t[i] = { i } end") == LUA_OK);
+}
+
+// 6. 프레임 GC 스케줄: 남는 시간 안에서만 진행, 힙이 너무 커지면 예산을 넘겨서라도 사이클 완료
+static void TestGcSchedule() {
+    LuaPoolAllocator pool;
+    lua_State* L = lua_newstate(&LuaPoolAllocator::Alloc, &pool);
+    luaL_openlibs(L);
+    GcSchedule gc;
+
+    CHECK(!SetGcMode(L, gc, "incrmental"));
+    CHECK(!gc.enabled && std::strcmp(GcModeName(gc), "auto") == 0);
+    RunScheduledGC(L, gc, 10.0, FakeNow); // 자동 GC일 때는 아무것도 안 함
+    CHECK(g_fakeNowMs == 0.0 && gc.cycles == 0);
+
+    CHECK(SetGcMode(L, gc, "incremental"));
+    CHECK(gc.enabled && std::strcmp(GcModeName(gc), "incremental") == 0);
+    CHECK(gc.lastCycleKB == (size_t)HeapKB(L));
+    // 진행 중이던 사이클을 끝내고, 스텝 하나를 아주 작게 해서 창 안에서 여러 번 돌게 함
+    lua_gc(L, LUA_GCCOLLECT);
+    lua_gc(L, LUA_GCINC, 0, 0, 1);
+    gc.lastCycleKB = (size_t)HeapKB(L);
+
+    // 창 = min(남은 시간, 예산). 시계를 두 번 보고 창을 넘기면 사이클 중간에서 멈춤
+    MakeGarbage(L, 8000);
+    const int grown = HeapKB(L);
+    CHECK((size_t)grown <= gc.lastCycleKB * 2 + 1024); // 강제 사이클 조건은 아님
+    gc.budgetMs = 2.0;
+    g_fakeTickMs = 0.5;
+    RunScheduledGC(L, gc, 1.0, FakeNow);
+    CHECK(gc.cycles == 0);
+    CHECK_NEAR(gc.lastFrameMs, 1.5, 1e-9); // 시작 0.5 -> 1.0 -> 1.5(창 넘김) -> 2.0
+    CHECK(gc.overBudgetFrames == 0);
+
+    // 남는 시간이 없으면 시계도 안 보고 넘어감
+    const double before = g_fakeNowMs;
+    RunScheduledGC(L, gc, -3.0, FakeNow);
+    CHECK(g_fakeNowMs == before && gc.lastFrameMs == 0.0 && gc.cycles == 0);
+
+    // 여러 프레임에 걸쳐 사이클을 끝내면 힙이 줄어듦
+    for (int frame = 0; frame < 1000 && gc.cycles == 0; frame++) RunScheduledGC(L, gc, 5.0, FakeNow);
+    CHECK(gc.cycles == 1);
+    CHECK(gc.lastCycleKB < (size_t)grown);
+
+    // 힙이 lastCycleKB * 2 + 1MB를 넘으면 남는 시간이 없어도 한 번에 사이클을 끝냄
+    MakeGarbage(L, 40000);
+    const uint64_t overBefore = gc.overBudgetFrames;
+    CHECK((size_t)HeapKB(L) > gc.lastCycleKB * 2 + 1024);
+    g_fakeTickMs = 3.0;
+    RunScheduledGC(L, gc, 0.0, FakeNow);
+    CHECK(gc.cycles == 2);
+    CHECK((size_t)HeapKB(L) <= gc.lastCycleKB + 64);
+    CHECK_NEAR(gc.lastFrameMs, 3.0, 1e-9);
+    CHECK(gc.overBudgetFrames == overBefore + 1); // 예산 2ms를 넘김
+
+    // 세대별 모드는 한 번에 마이너 수집 한 번
+    CHECK(SetGcMode(L, gc, "generational"));
+    g_fakeTickMs = 0.5;
+    RunScheduledGC(L, gc, 1.0, FakeNow);
+    CHECK(gc.cycles == 3 && gc.overBudgetFrames == overBefore + 1);
+
+    CHECK(SetGcMode(L, gc, "auto"));
+    CHECK(!gc.enabled);
+    lua_close(L);
+}
+#endif
+
+int main() {
+    TestReallocPaths();
+    TestFreeListsPerPool();
+    TestFrameStats();
+    TestShrinkWhenPoolExhausted();
+#if defined(TODOKI_HAVE_LUA)
+    TestLuaStates();
+    TestGcSchedule();
+#endif
+    return CheckResult("test_lua_alloc");
+}
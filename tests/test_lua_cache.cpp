@@ -0,0 +1,182 @@
+#include "lua_cache.h"
+#include "check.h"
+#include <lua.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// 호출할 때마다 1ms씩 흐르는 시계 (readMs/compileMs가 시계를 거치는지 확인)
+static double g_fakeNowMs = 0.0;
+static double FakeNow() { return g_fakeNowMs += 1.0; }
+
+static void WriteFile(const fs::path& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// 청크를 로드해서 실행하고 돌려준 정수 (실패하면 -1)
+static lua_Integer Run(lua_State* L, const std::string& path) {
+    if (LoadLuaChunk(L, path) != LUA_OK) {
+        lua_pop(L, 1);
+        return -1;
+    }
+    if (lua_pcall(L, 0, 1, 0) != LUA_OK) {
+        lua_pop(L, 1);
+        return -1;
+    }
+    lua_Integer v = lua_tointeger(L, -1);
+    lua_pop(L, 1);
+    return v;
+}
+
+// 디스크 캐시의 .luac 파일 수
+static int DiskEntries() {
+    int n = 0;
+    std::error_code ec;
+    for (const auto& e : fs::directory_iterator(".luacache", ec)) n += e.path().extension() == ".luac";
+    return n;
+}
+
+// 1. 미스 -> 메모리 히트 -> (새 실행) 디스크 히트
+static void TestHitMiss() {
+    WriteFile("main.lua", "return 1");
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    PrefetchLuaSources("main.lua");
+    CHECK(Run(L, "main.lua") == 1);
+    CHECK(g_chunkCacheStats.misses == 1 && g_chunkCacheStats.hits == 0);
+    CHECK(g_chunkCacheStats.readMs == 1.0 && g_chunkCacheStats.compileMs == 1.0);
+    CHECK(DiskEntries() == 1);
+
+    PrefetchLuaSources("main.lua"); // 리로드: 통계는 새로
+    CHECK(g_chunkCacheStats.misses == 0);
+    CHECK(Run(L, "main.lua") == 1);
+    CHECK(g_chunkCacheStats.hits == 1 && g_chunkCacheStats.misses == 0);
+    CHECK(g_chunkCacheStats.compileMs == 0.0);
+
+    // 없는 파일은 LUA_ERRFILE
+    CHECK(LoadLuaChunk(L, "nope.lua") == LUA_ERRFILE);
+    lua_pop(L, 1);
+
+    // 캐시를 끄면 매번 소스에서
+    g_useChunkCache = false;
+    PrefetchLuaSources("main.lua");
+    CHECK(Run(L, "main.lua") == 1);
+    CHECK(g_chunkCacheStats.hits == 0 && g_chunkCacheStats.misses == 0);
+    g_useChunkCache = true;
+    lua_close(L);
+}
+
+// 2. 프리페치한 뒤 소스가 바뀌면 (수정 시각 또는 크기) 다시 읽고 다시 컴파일
+static void TestStaleAfterRewrite() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    PrefetchLuaSources("main.lua");
+    WaitForPrefetch(); // 워커가 예전 내용을 읽은 뒤에 고침
+    const auto stamp = fs::last_write_time("main.lua");
+    WriteFile("main.lua", "return 2"); // 크기는 같고 수정 시각만 다름
+    fs::last_write_time("main.lua", stamp + std::chrono::seconds(2));
+    CHECK(Run(L, "main.lua") == 2);
+    CHECK(g_chunkCacheStats.misses == 1 && g_chunkCacheStats.hits == 0);
+
+    PrefetchLuaSources("main.lua");
+    WaitForPrefetch();
+    const auto stamp2 = fs::last_write_time("main.lua");
+    WriteFile("main.lua", "return 300"); // 수정 시각은 그대로, 크기만 다름
+    fs::last_write_time("main.lua", stamp2);
+    CHECK(Run(L, "main.lua") == 300);
+    CHECK(g_chunkCacheStats.misses == 1 && g_chunkCacheStats.hits == 0);
+
+    // 예전 내용으로 되돌리면 디스크 캐시가 해시로 거절하고 다시 컴파일
+    WriteFile("main.lua", "return 2");
+    PrefetchLuaSources("main.lua");
+    CHECK(Run(L, "main.lua") == 2);
+    CHECK(g_chunkCacheStats.misses == 1);
+    lua_close(L);
+}
+
+// 3. 소스가 사라진 경로는 다음 프리페치 때 매니페스트와 .luac에서 정리
+static void TestMissingSource() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    WriteFile("gone.lua", "return 7");
+    PrefetchLuaSources("main.lua");
+    CHECK(Run(L, "gone.lua") == 7);
+    CHECK(DiskEntries() == 2);
+
+    fs::remove("gone.lua");
+    PrefetchLuaSources("main.lua");
+    CHECK(DiskEntries() == 1);
+    std::ifstream manifest(".luacache/manifest.txt");
+    std::string line;
+    bool listed = false;
+    while (std::getline(manifest, line)) listed |= line == "gone.lua";
+    CHECK(!listed);
+
+    // 다시 생기면 메모리 캐시에도 남아 있지 않으므로 새로 컴파일
+    WriteFile("gone.lua", "return 8");
+    CHECK(Run(L, "gone.lua") == 8);
+    CHECK(g_chunkCacheStats.misses == 1);
+    lua_close(L);
+}
+
+// 4. package.searchers[2] 교체: require도 캐시를 거치고 원래 searcher는 뒤로 밀림
+static void TestSearcher() {
+    fs::create_directories("lib");
+    WriteFile("lib/mod.lua", "return { answer = 42, name = ... }");
+
+    for (int run = 0; run < 2; run++) {
+        lua_State* L = luaL_newstate();
+        luaL_openlibs(L);
+        lua_getglobal(L, "package");
+        lua_getfield(L, -1, "searchers");
+        const lua_Integer before = (lua_Integer)luaL_len(L, -1);
+        lua_pop(L, 2);
+
+        PrefetchLuaSources("main.lua");
+        InstallChunkSearcher(L);
+        const std::string script =
+            "package.path = './lib/?.lua' "
+            "local m, where = require('mod') "
+            "assert(m.answer == 42 and m.name == 'mod' and where == './lib/mod.lua') "
+            "assert(#package.searchers == " + std::to_string(before + 1) + ") "
+            "assert(package.searchers[1] ~= package.searchers[2])";
+        CHECK(luaL_dostring(L, script.c_str()) == LUA_OK);
+        // 처음엔 미스, 새 상태(리로드)에서는 메모리 캐시 히트
+        CHECK(g_chunkCacheStats.misses == (run == 0 ? 1 : 0));
+        CHECK(g_chunkCacheStats.hits == (run == 0 ? 0 : 1));
+
+        // 못 찾으면 기본 searcher들의 메시지로, 문법 오류는 모듈 로드 오류로
+        CHECK(luaL_dostring(L, "return require('missing_mod')") != LUA_OK);
+        lua_pop(L, 1);
+        WriteFile("lib/bad.lua", "return {");
+        CHECK(luaL_dostring(L, "return require('bad')") != LUA_OK);
+        CHECK(std::string(lua_tostring(L, -1)).find("error loading module 'bad'") != std::string::npos);
+        lua_pop(L, 1);
+        lua_close(L);
+    }
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "todoki_test_lua_cache";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+    const fs::path cwd = fs::current_path();
+    fs::current_path(dir); // 디스크 캐시는 작업 디렉터리 기준
+
+    SetChunkCacheClock(FakeNow);
+    TestHitMiss();
+    TestStaleAfterRewrite();
+    TestMissingSource();
+    TestSearcher();
+    WaitForPrefetch();
+
+    fs::current_path(cwd);
+    fs::remove_all(dir, ec);
+    return CheckResult("test_lua_cache");
+}
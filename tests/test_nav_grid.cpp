@@ -0,0 +1,188 @@
+#include "nav_grid.h"
+#include "check.h"
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <random>
+
+// 우선순위 큐 다익스트라 기준값: (sx, sy)에서 (tx, ty)까지 비용, 못 가면 kUnreachable
+static uint32_t ReferenceCost(const NavSnapshot& g, int sx, int sy, int tx, int ty, bool diagonal) {
+    const int w = g.Width(), h = g.Height();
+    if (g.Blocked(sx, sy) || g.Blocked(tx, ty)) return NavFlowField::kUnreachable;
+    static const int dx[8] = { 0, 0, -1, 1, -1, 1, -1, 1 }, dy[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+    std::vector<uint32_t> dist((size_t)w * h, NavFlowField::kUnreachable);
+    using Item = std::pair<uint32_t, size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> q;
+    dist[(size_t)sy * w + sx] = 0;
+    q.push({ 0, (size_t)sy * w + sx });
+    while (!q.empty()) {
+        auto [cost, i] = q.top();
+        q.pop();
+        if (cost != dist[i]) continue;
+        const int x = (int)(i % w), y = (int)(i / w);
+        for (int k = 0; k < (diagonal ? 8 : 4); k++) {
+            const int nx = x + dx[k], ny = y + dy[k];
+            if (g.Blocked(nx, ny)) continue;
+            if (k >= 4 && (g.Blocked(x + dx[k], y) || g.Blocked(x, y + dy[k]))) continue;
+            const uint32_t nc = cost + (k < 4 ? 10 : 14);
+            const size_t n = (size_t)ny * w + nx;
+            if (nc < dist[n]) {
+                dist[n] = nc;
+                q.push({ nc, n });
+            }
+        }
+    }
+    return dist[(size_t)ty * w + tx];
+}
+
+// 1. 무작위 격자에서 A* 비용과 흐름장 거리가 기준 다익스트라와 같고, 경로/흐름을 따라가면 목표에 닿음
+static void TestMatchesDijkstra() {
+    std::mt19937 rng(1);
+    for (int it = 0; it < 300; it++) {
+        const int w = 5 + rng() % 60, h = 5 + rng() % 60;
+        NavGrid grid(w, h);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                if (rng() % 100 < 30) grid.Set(x, y, true);
+            }
+        }
+        if (it % 3 == 0) grid.Fill(rng() % w, rng() % h, rng() % 20, rng() % 20, rng() % 2);
+        auto snap = grid.Snapshot();
+        const bool diagonal = it % 2;
+        const int sx = rng() % w, sy = rng() % h, tx = rng() % w, ty = rng() % h;
+
+        NavPath path = FindNavPath(*snap, sx, sy, tx, ty, diagonal);
+        const uint32_t ref = ReferenceCost(*snap, sx, sy, tx, ty, diagonal);
+        CHECK(path.found == (ref != NavFlowField::kUnreachable));
+        if (path.found) {
+            CHECK(path.cost == ref);
+            const size_t n = path.points.size();
+            CHECK(path.points[0] == sx && path.points[1] == sy && path.points[n - 2] == tx && path.points[n - 1] == ty);
+            uint32_t cost = 0;
+            for (size_t i = 0; i < n; i += 2) {
+                CHECK(!snap->Blocked(path.points[i], path.points[i + 1]));
+                if (i == 0) continue;
+                const int ddx = std::abs(path.points[i] - path.points[i - 2]), ddy = std::abs(path.points[i + 1] - path.points[i - 1]);
+                CHECK(ddx <= 1 && ddy <= 1 && ddx + ddy > 0);
+                cost += ddx + ddy == 2 ? 14 : 10;
+            }
+            CHECK(cost == path.cost);
+        }
+
+        NavFlowField field = BuildNavFlowField(*snap, tx, ty, diagonal);
+        for (int k = 0; k < 5; k++) {
+            const int x = rng() % w, y = rng() % h;
+            const uint32_t r = ReferenceCost(*snap, x, y, tx, ty, diagonal);
+            CHECK(field.dist[(size_t)y * w + x] == r);
+            if (r == NavFlowField::kUnreachable) continue;
+            int cx = x, cy = y, steps = 0;
+            while ((cx != tx || cy != ty) && steps++ < w * h) {
+                int ddx, ddy;
+                NavDirection(field.dir[(size_t)cy * w + cx], ddx, ddy);
+                if (ddx == 0 && ddy == 0) break;
+                cx += ddx;
+                cy += ddy;
+                CHECK(!snap->Blocked(cx, cy));
+            }
+            CHECK(cx == tx && cy == ty);
+        }
+
+        // 스냅샷은 그대로이고, 탐색이 읽은 출발 칸을 고치면 결과가 무효가 됨
+        CHECK(grid.IsCurrent(path.deps));
+        const bool before = snap->Blocked(sx, sy);
+        grid.Set(sx, sy, !before);
+        CHECK(snap->Blocked(sx, sy) == before);
+        CHECK(grid.Blocked(sx, sy) != before);
+        CHECK(!grid.IsCurrent(path.deps));
+    }
+}
+
+// 2. 읽지 않은 청크를 고치면 결과가 유지되고, 바뀐 게 없으면 버전도 그대로
+static void TestDepsAndVersions() {
+    NavGrid grid(256, 256);
+    NavPath path = FindNavPath(*grid.Snapshot(), 0, 0, 10, 0, true);
+    CHECK(path.found && path.cost == 100);
+    grid.Set(200, 200, true);
+    CHECK(grid.IsCurrent(path.deps));
+    grid.Set(5, 1, true);
+    CHECK(!grid.IsCurrent(path.deps));
+
+    const uint32_t version = grid.Version();
+    grid.Set(200, 200, true);             // 이미 막힘
+    grid.Fill(190, 190, 20, 20, false);   // 200,200만 풀림
+    CHECK(grid.Version() == version + 1);
+    grid.Fill(190, 190, 20, 20, false);
+    CHECK(grid.Version() == version + 1);
+    auto a = grid.Snapshot();
+    CHECK(a == grid.Snapshot());          // 고친 게 없으면 같은 스냅샷
+}
+
+// 3. 크기 상한: 칸 수가 kNavMaxCells를 넘거나 한 변이 0xFFFF를 넘으면 만들지 않음
+static void TestSizeLimits() {
+    CHECK(NavGridSizeOk(1, 1));
+    CHECK(NavGridSizeOk(4096, 4096));
+    CHECK(NavGridSizeOk(0xFFFF, 256));
+    CHECK(!NavGridSizeOk(4097, 4096));
+    CHECK(!NavGridSizeOk(0xFFFF, 0xFFFF));  // int로 곱하면 넘치는 크기
+    CHECK(!NavGridSizeOk(0x10000, 1));
+    CHECK(!NavGridSizeOk(0, 10));
+    CHECK(!NavGridSizeOk(-5, -5));
+
+    NavGrid tooBig(0xFFFF, 0xFFFF);
+    CHECK(tooBig.Width() == 0 && tooBig.Height() == 0);
+    CHECK(tooBig.Blocked(0, 0));
+    tooBig.Set(0, 0, false);
+    CHECK(!FindNavPath(*tooBig.Snapshot(), 0, 0, 1, 1, true).found);
+
+    // 한 변이 최대인 격자에서 끝에서 끝까지
+    NavGrid wide(0xFFFF, 2);
+    wide.Fill(1, 0, 0xFFFF - 2, 1, true);
+    NavPath path = FindNavPath(*wide.Snapshot(), 0, 0, 0xFFFE, 0, false);
+    CHECK(path.found && path.cost == 10u * (0xFFFE + 2));
+}
+
+// 4. 작업 스레드가 스냅샷을 읽는 동안 메인 스레드가 격자를 고쳐도 됨
+static void TestConcurrentEdits() {
+    std::mt19937 rng(3);
+    NavGrid grid(320, 320);
+    NavWorkers workers(4);
+    std::atomic<int> done{ 0 }, found{ 0 };
+    for (int i = 0; i < 200; i++) {
+        auto snap = grid.Snapshot();
+        workers.Submit([snap, &done, &found] {
+            if (FindNavPath(*snap, 1, 1, 300, 300, true).found) found++;
+            done++;
+            });
+        grid.Fill(rng() % 320, rng() % 320, 5, 5, rng() % 2);
+    }
+    while (done < 200) std::this_thread::yield();
+    workers.Stop();
+    CHECK(found > 0);
+}
+
+// 5. 큰 격자 다음에 훨씬 작은 격자를 풀면 스레드 탐색 버퍼가 줄어듦
+static void TestScratchShrinks() {
+    NavGrid big(1024, 1024);
+    CHECK(FindNavPath(*big.Snapshot(), 0, 0, 1023, 1023, true).found);
+    const size_t bigBytes = NavScratchBytes();
+    CHECK(bigBytes >= (size_t)1024 * 1024 * 12);
+
+    // 비슷한 크기면 그대로 씀
+    NavGrid similar(600, 600);
+    CHECK(FindNavPath(*similar.Snapshot(), 0, 0, 599, 599, true).found);
+    CHECK(NavScratchBytes() >= bigBytes);
+
+    NavGrid small(32, 32);
+    CHECK(FindNavPath(*small.Snapshot(), 0, 0, 31, 31, true).found);
+    CHECK(NavScratchBytes() < (size_t)1024 * 1024);
+}
+
+int main() {
+    TestMatchesDijkstra();
+    TestDepsAndVersions();
+    TestSizeLimits();
+    TestConcurrentEdits();
+    TestScratchShrinks();
+    return CheckResult("test_nav_grid");
+}
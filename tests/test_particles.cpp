@@ -0,0 +1,118 @@
+#include "particles.h"
+#include "check.h"
+#include <vector>
+
+// 1. 에미터마다 시드가 달라서 같은 설정이어도 다른 위치에 방출
+static void TestSeedsDiffer() {
+    ParticleEmitter a, b;
+    for (auto* e : { &a, &b }) {
+        e->spreadX = 100.0f;
+        e->spreadY = 100.0f;
+        e->Emit(4);
+    }
+    bool same = true;
+    for (uint32_t i = 0; i < 4; i++) {
+        if (a.px[i] != b.px[i] || a.py[i] != b.py[i]) same = false;
+    }
+    CHECK(!same);
+
+    // 같은 시드를 주면 같은 흐름을 재현
+    ParticleEmitter c, d;
+    c.Seed(1234);
+    d.Seed(1234);
+    c.spreadX = d.spreadX = 100.0f;
+    c.Emit(8);
+    d.Emit(8);
+    for (uint32_t i = 0; i < 8; i++) CHECK(c.px[i] == d.px[i]);
+
+    // 0 시드에서도 xorshift가 멈추지 않음
+    ParticleEmitter z;
+    z.Seed(0);
+    z.spreadX = 100.0f;
+    z.Emit(2);
+    CHECK(z.px[0] != z.px[1]);
+}
+
+// 2. maxCount와 kMaxCount 상한
+static void TestMaxCount() {
+    ParticleEmitter e;
+    e.maxCount = 100;
+    e.Emit(1000);
+    CHECK(e.count == 100);
+    e.Emit(1);
+    CHECK(e.count == 100);
+
+    e.maxCount = 0xFFFFFFFFu;
+    e.Emit(0xFFFFFFFFu);
+    CHECK(e.count == ParticleEmitter::kMaxCount);
+}
+
+// 3. SIMD 경로가 스칼라 식과 같은 값을 내는지 (꼬리 처리 포함)
+static void TestKernelMatchesScalar() {
+    ParticleEmitter e;
+    e.spreadX = e.spreadY = 50.0f;
+    e.speedMin = 10.0f;
+    e.speedMax = 200.0f;
+    e.lifeMin = 5.0f;
+    e.lifeMax = 10.0f;
+    e.spinMin = -3.0f;
+    e.spinMax = 3.0f;
+    e.gravityX = 5.0f;
+    e.gravityY = 98.0f;
+    e.drag = 0.5f;
+    e.sizeStart = 4.0f;
+    e.sizeEnd = 20.0f;
+    e.colorEnd[0] = 0.25f;
+    e.Emit(1003);
+
+    const uint32_t n = e.count;
+    std::vector<float> px(e.px.begin(), e.px.begin() + n), py(e.py.begin(), e.py.begin() + n);
+    std::vector<float> vx(e.vx.begin(), e.vx.begin() + n), vy(e.vy.begin(), e.vy.begin() + n);
+    std::vector<float> life(e.life.begin(), e.life.begin() + n), rot(e.rot.begin(), e.rot.begin() + n);
+
+    const float dt = 1.0f / 60.0f;
+    e.Update(dt);
+    CHECK(e.count == n);
+
+    const float dragK = 1.0f - e.drag * dt;
+    for (uint32_t i = 0; i < n; i++) {
+        float l = life[i] - dt;
+        float t = 1.0f - l * e.invLife[i];
+        float velX = (vx[i] + e.gravityX * dt) * dragK;
+        float velY = (vy[i] + e.gravityY * dt) * dragK;
+        CHECK_NEAR(e.life[i], l, 1e-5);
+        CHECK_NEAR(e.vx[i], velX, 1e-3);
+        CHECK_NEAR(e.vy[i], velY, 1e-3);
+        CHECK_NEAR(e.px[i], px[i] + velX * dt, 1e-3);
+        CHECK_NEAR(e.py[i], py[i] + velY * dt, 1e-3);
+        CHECK_NEAR(e.rot[i], rot[i] + e.spin[i] * dt, 1e-5);
+        CHECK_NEAR(e.size[i], e.sizeStart + (e.sizeEnd - e.sizeStart) * t, 1e-4);
+        CHECK_NEAR(e.r[i], 1.0f + (0.25f - 1.0f) * t, 1e-5);
+        CHECK_NEAR(e.a[i], 1.0f - t, 1e-5);
+    }
+}
+
+// 4. 수명이 다한 파티클은 압축으로 빠지고, rate만큼 새로 방출
+static void TestCompactAndSpawn() {
+    ParticleEmitter e;
+    e.lifeMin = 0.1f;
+    e.lifeMax = 0.1f;
+    e.Emit(37);
+    e.Update(0.05f);
+    CHECK(e.count == 37);
+    e.Update(0.06f);
+    CHECK(e.count == 0);
+
+    e.rate = 100.0f;
+    e.Update(0.5f);
+    CHECK(e.count == 50);
+    for (uint32_t i = 0; i < e.count; i++) CHECK(e.life[i] > 0.0f);
+}
+
+int main() {
+    TestSeedsDiffer();
+    TestMaxCount();
+    TestKernelMatchesScalar();
+    TestCompactAndSpawn();
+    return CheckResult("test_particles");
+}
@@ -0,0 +1,119 @@
+#include "sprite_anim.h"
+#include "check.h"
+
+static SpriteSheet MakeSheet() {
+    SpriteSheet sheet;
+    sheet.frames.resize(4); // 모두 100ms
+    sheet.frameNames = { { "idle_0", 0 }, { "walk_3", 3 } };
+    sheet.tags = {
+        { "walk", 0, 3, AnimDirection::Forward, 0 },
+        { "back", 1, 3, AnimDirection::Reverse, 0 },
+        { "pp", 0, 2, AnimDirection::PingPong, 0 },
+        { "once", 2, 3, AnimDirection::Forward, 1 },
+        { "ppr", 0, 2, AnimDirection::PingPongReverse, 1 },
+    };
+    return sheet;
+}
+
+// 1. 방향별 프레임 순서와 바퀴 수
+static void TestDirections() {
+    const SpriteSheet sheet = MakeSheet();
+    CHECK(sheet.FindTag("pp") == 2 && sheet.FindTag("run") == -1);
+    CHECK(sheet.FindFrame("walk_3") == 3 && sheet.FindFrame("x") == -1);
+
+    AnimPool pool;
+    AnimState& walk = *pool.Get(pool.Create(&sheet, sheet.FindTag("walk")));
+    pool.Update(100.0f);
+    CHECK(walk.frame == 1);
+    pool.Update(250.0f);
+    CHECK(walk.frame == 3 && walk.loops == 0);
+    pool.Update(100.0f);
+    CHECK(walk.frame == 0 && walk.loops == 1);
+
+    AnimPool pool2;
+    AnimState& back = *pool2.Get(pool2.Create(&sheet, sheet.FindTag("back")));
+    CHECK(back.frame == 3);
+    pool2.Update(300.0f); // 3 -> 2 -> 1 -> 3
+    CHECK(back.frame == 3 && back.loops == 1);
+
+    // 왕복: 시작한 끝으로 돌아왔을 때 한 바퀴
+    AnimPool pool3;
+    AnimState& pp = *pool3.Get(pool3.Create(&sheet, sheet.FindTag("pp")));
+    const int expected[] = { 1, 2, 1, 0, 1 };
+    for (int f : expected) {
+        pool3.Update(100.0f);
+        CHECK(pp.frame == f);
+    }
+    CHECK(pp.loops == 1);
+
+    // 반대쪽에서 출발하는 왕복, 한 바퀴만
+    AnimPool pool4;
+    AnimState& ppr = *pool4.Get(pool4.Create(&sheet, sheet.FindTag("ppr")));
+    CHECK(ppr.frame == 2);
+    pool4.Update(400.0f); // 2 -> 1 -> 0 -> 1 -> 2
+    CHECK(ppr.frame == 2 && ppr.playing);
+    pool4.Update(100.0f); // 시작한 끝에서 다시 꺾이면 한 바퀴
+    CHECK(ppr.done && !ppr.playing && ppr.loops == 1);
+}
+
+// 2. repeat, 속도, 아주 큰 dt
+static void TestRepeatSpeedAndLongPause() {
+    const SpriteSheet sheet = MakeSheet();
+    AnimPool pool;
+    AnimState& once = *pool.Get(pool.Create(&sheet, sheet.FindTag("once")));
+    pool.Update(150.0f);
+    CHECK(once.frame == 3 && once.playing);
+    pool.Update(100.0f);
+    CHECK(once.done && !once.playing && once.frame == 3); // 마지막 프레임에서 멈춤
+    pool.Update(1000.0f);
+    CHECK(once.frame == 3);
+
+    // repeat 덮어쓰기, 없는 태그는 시트 전체
+    AnimPool::Play(once, sheet.FindTag("walk"), 2);
+    pool.Update(799.0f);
+    CHECK(once.playing);
+    pool.Update(1.0f);
+    CHECK(once.done && once.loops == 2);
+    AnimPool::Play(once, 99);
+    CHECK(once.tag == -1 && once.from == 0 && once.to == 3 && once.repeat == 0);
+
+    AnimPool fast;
+    AnimState& a = *fast.Get(fast.Create(&sheet, sheet.FindTag("walk")));
+    a.speed = 2.0f;
+    fast.Update(100.0f);
+    CHECK(a.frame == 2);
+
+    // 창을 오래 멈췄다 돌아와도 한 바퀴 안으로 접혀서 바로 끝남
+    a.speed = 1.0f;
+    fast.Update(1.0e7f);
+    CHECK(a.frame >= 0 && a.frame <= 3 && a.loops < 10);
+    CHECK(a.timeMs < 100.0f);
+}
+
+// 3. 풀: 지운 핸들은 무효, 옮겨진 상태는 그대로, 슬롯 재사용 시 세대 증가
+static void TestPool() {
+    const SpriteSheet sheet = MakeSheet();
+    AnimPool pool;
+    AnimHandle h[3];
+    for (int i = 0; i < 3; i++) h[i] = pool.Create(&sheet, sheet.FindTag("walk"));
+    pool.Get(h[2])->speed = 2.0f;
+    pool.Update(100.0f);
+
+    pool.Destroy(h[0]);
+    CHECK(pool.Get(h[0]) == nullptr);
+    CHECK(pool.Count() == 2);
+    CHECK(pool.Get(h[2])->frame == 2 && pool.Get(h[2])->slot == h[2].slot);
+    CHECK(pool.Get(h[1])->frame == 1);
+    pool.Destroy(h[0]); // 두 번 지워도 무시
+
+    AnimHandle reused = pool.Create(&sheet, -1);
+    CHECK(reused.slot == h[0].slot && reused.generation == h[0].generation + 1);
+    CHECK(pool.Get(h[0]) == nullptr && pool.Get(reused) != nullptr);
+}
+
+int main() {
+    TestDirections();
+    TestRepeatSpeedAndLongPause();
+    TestPool();
+    return CheckResult("test_sprite_anim");
+}
@@ -0,0 +1,128 @@
+#include "tween.h"
+#include "check.h"
+#include <algorithm>
+
+// 엔진(lua_tween.cpp)과 같은 순서로 한 프레임 진행: 시작한 트윈은 현재 값에서 출발, 값 쓰기, 정리
+struct Frame {
+    std::vector<uint32_t> finished, cancelled, freed;
+};
+static Frame Step(TweenPool& pool, float dtms, std::vector<float>& targets) {
+    Frame f;
+    pool.Advance(dtms);
+    for (uint32_t i : pool.Started()) pool.SetFrom(i, targets[pool.Target(i)]);
+    pool.Evaluate();
+    for (uint32_t i : pool.Active()) targets[pool.Target(i)] = pool.Value(i);
+    pool.Collect(f.finished, f.cancelled, f.freed);
+    return f;
+}
+
+static bool Contains(const std::vector<uint32_t>& v, uint32_t x) {
+    return std::find(v.begin(), v.end(), x) != v.end();
+}
+
+// 1. 이징 이름, 모든 이징이 0에서 출발해 정확히 목표에서 끝남
+static void TestEases() {
+    Ease e;
+    CHECK(ParseEase("quadOut", e) && e == Ease::QuadOut);
+    CHECK(ParseEase("bounceOut", e) && e == Ease::BounceOut);
+    CHECK(!ParseEase("quadout", e));
+    CHECK(!ParseEase("", e));
+
+    for (int k = 0; k < (int)Ease::Count; k++) {
+        TweenPool pool;
+        std::vector<float> targets = { 10.0f };
+        auto g = pool.CreateGroup(100.0f, 0.0f, (Ease)k, nullptr);
+        pool.AddTween(g, 50.0f, 0);
+        Step(pool, 0.0f, targets);
+        CHECK_NEAR(targets[0], 10.0f, 1e-3);
+        Frame f = Step(pool, 100.0f, targets);
+        CHECK_NEAR(targets[0], 50.0f, 1e-3);
+        CHECK(f.finished.size() == 1 && !pool.IsAlive(g));
+    }
+
+    TweenPool pool;
+    std::vector<float> targets = { 0.0f, 0.0f };
+    pool.AddTween(pool.CreateGroup(100.0f, 0.0f, Ease::Linear), 100.0f, 0);
+    pool.AddTween(pool.CreateGroup(100.0f, 0.0f, Ease::QuadIn), 100.0f, 1);
+    Step(pool, 50.0f, targets);
+    CHECK_NEAR(targets[0], 50.0f, 1e-3);
+    CHECK_NEAR(targets[1], 25.0f, 1e-3);
+}
+
+// 2. 지연: 지연을 넘긴 만큼은 진행된 상태로 시작, 시작 시점의 현재 값에서 출발
+static void TestDelay() {
+    TweenPool pool;
+    std::vector<float> targets = { 0.0f };
+    auto g = pool.CreateGroup(100.0f, 30.0f, Ease::Linear);
+    pool.AddTween(g, 100.0f, 0);
+    Step(pool, 20.0f, targets);
+    CHECK(targets[0] == 0.0f);
+    targets[0] = 20.0f; // 지연 중에 다른 코드가 값을 바꿈
+    Step(pool, 20.0f, targets);
+    CHECK_NEAR(targets[0], 28.0f, 1e-3); // 20 + (100 - 20) * 0.1
+}
+
+// 3. after 순서: 앞 그룹이 끝난 뒤 지연을 세기 시작, 앞이 취소되면 뒤도 취소
+static void TestSequenceAndCancel() {
+    TweenPool pool;
+    std::vector<float> targets = { 0.0f, 0.0f, 0.0f };
+    auto a = pool.CreateGroup(50.0f, 0.0f, Ease::Linear);
+    pool.AddTween(a, 10.0f, 0);
+    auto b = pool.CreateGroup(50.0f, 10.0f, Ease::Linear, &a);
+    pool.AddTween(b, 10.0f, 1);
+    auto c = pool.CreateGroup(50.0f, 0.0f, Ease::Linear, &b);
+    pool.AddTween(c, 10.0f, 2);
+
+    Frame f = Step(pool, 50.0f, targets);
+    CHECK(Contains(f.finished, a.slot));
+    CHECK(targets[0] == 10.0f && targets[1] == 0.0f);
+    Step(pool, 5.0f, targets);
+    CHECK(targets[1] == 0.0f);           // 아직 지연 중
+    Step(pool, 10.0f, targets);
+    CHECK_NEAR(targets[1], 1.0f, 1e-3);  // 지연 10ms를 5ms 넘김
+
+    CHECK(pool.Cancel(b));
+    CHECK(!pool.IsAlive(b) && !pool.IsAlive(c));
+    CHECK(!pool.Cancel(b));
+    f = Step(pool, 16.0f, targets);
+    CHECK(f.cancelled.size() == 2 && Contains(f.cancelled, b.slot) && Contains(f.cancelled, c.slot));
+    CHECK(Contains(f.freed, 1) && Contains(f.freed, 2));
+    CHECK(pool.TweenCount() == 0 && pool.GroupCount() == 0);
+
+    // 끝나서 반환된 슬롯은 세대가 바뀌어 옛 핸들이 새 그룹을 가리키지 않음
+    auto d = pool.CreateGroup(10.0f, 0.0f, Ease::Linear);
+    auto stale = TweenGroupHandle{ d.slot, d.generation - 1 };
+    CHECK(pool.IsAlive(d) && !pool.IsAlive(stale));
+    pool.AddTween(stale, 5.0f, 0);
+    CHECK(pool.TweenCount() == 0);
+    // 이미 끝난 그룹을 after로 주면 바로 지연을 셈
+    auto e = pool.CreateGroup(10.0f, 0.0f, Ease::Linear, &a);
+    pool.AddTween(e, 7.0f, 2);
+    Step(pool, 10.0f, targets);
+    CHECK(targets[2] == 7.0f);
+}
+
+// 4. 여러 그룹이 섞여 끝나도 swap-remove 뒤에 남은 트윈의 타깃이 그대로
+static void TestSwapRemove() {
+    TweenPool pool;
+    std::vector<float> targets(64, 0.0f);
+    for (uint32_t t = 0; t < 64; t++) {
+        auto g = pool.CreateGroup(10.0f * (1 + t % 4), 0.0f, Ease::Linear);
+        pool.AddTween(g, (float)t, t);
+    }
+    for (int frame = 0; frame < 4; frame++) Step(pool, 10.0f, targets);
+    CHECK(pool.TweenCount() == 0);
+    for (uint32_t t = 0; t < 64; t++) CHECK(targets[t] == (float)t);
+
+    pool.AddTween(pool.CreateGroup(10.0f, 0.0f, Ease::Linear), 1.0f, 0);
+    pool.Clear();
+    CHECK(pool.TweenCount() == 0 && pool.GroupCount() == 0);
+}
+
+int main() {
+    TestEases();
+    TestDelay();
+    TestSequenceAndCancel();
+    TestSwapRemove();
+    return CheckResult("test_tween");
+}
@@ -0,0 +1,165 @@
+#include "watchdog.h"
+#include "check.h"
+#include <lua.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// sys.watchdog와 같은 설정으로 헤드리스 상태에 감시를 붙여 느린 스크립트를 돌립니다.
+static const char* kScript = R"(
+    function spin(ms)
+        local t = os.clock()
+        while os.clock() - t < ms / 1000 do end
+    end
+    function slow_update() spin(150) end
+    function fast_update() spin(1) end
+    function busy_in_co() spin(150) coroutine.yield() end
+    function run_co()
+        local co = coroutine.wrap(busy_in_co)
+        co()
+    end
+)";
+
+static std::string LogPath() {
+    return (std::filesystem::temp_directory_path() / "todoki_test_hitch.log").string();
+}
+
+static std::string ReadLog() {
+    std::ifstream file(LogPath());
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+static void CallPhase(HitchWatchdog& watchdog, lua_State* L, const char* phase, const char* fn) {
+    HitchPhase hitchPhase(watchdog, phase);
+    lua_getglobal(L, fn);
+    if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        std::fprintf(stderr, "lua error: %s\n", lua_tostring(L, -1));
+        g_checkFailures++;
+        lua_pop(L, 1);
+    }
+}
+
+static HitchWatchdog::Config TestConfig() {
+    HitchWatchdog::Config cfg;
+    cfg.budgetMs = 20.0;
+    cfg.file = LogPath();
+    return cfg;
+}
+
+// 1. 예산을 넘긴 구간은 한 번만 보고되고, 스택과 부가 정보, 실제 걸린 시간이 남음
+static void TestSlowPhase(lua_State* L) {
+    std::error_code ec;
+    std::filesystem::remove(LogPath(), ec);
+
+    HitchWatchdog watchdog;
+    watchdog.Start(L, TestConfig(), [](lua_State*) { return std::string("  describe: ok"); });
+    CallPhase(watchdog, L, "update", "fast_update");
+    CHECK(lua_gethook(L) == nullptr); // 예산 안에서는 훅 없이 실행
+
+    CallPhase(watchdog, L, "update", "slow_update");
+    CHECK(lua_gethook(L) == nullptr); // 잡은 뒤에는 스스로 빠짐
+    CallPhase(watchdog, L, "draw", "fast_update");
+    watchdog.Stop();
+    CHECK(lua_gethook(L) == nullptr);
+
+    const std::string log = ReadLog();
+    CHECK(watchdog.HitchCount() == 1);
+    CHECK(log.find("phase=update") != std::string::npos);
+    CHECK(log.find("phase=draw") == std::string::npos);
+    CHECK(log.find("slow_update") != std::string::npos);
+    CHECK(log.find("describe: ok") != std::string::npos);
+    CHECK(log.find("ended after") != std::string::npos);
+}
+
+// 2. HitchRunningThread로 표시한 코루틴 안에서 멈추면 그 코루틴의 스택이 잡힘 (AsyncScheduler::Resume과 같음)
+static void TestCoroutineHitch(lua_State* L) {
+    std::error_code ec;
+    std::filesystem::remove(LogPath(), ec);
+
+    HitchWatchdog watchdog;
+    watchdog.Start(L, TestConfig(), nullptr);
+    {
+        HitchPhase hitchPhase(watchdog, "async");
+        lua_State* co = lua_newthread(L);
+        lua_getglobal(co, "busy_in_co");
+        int nres = 0;
+        HitchRunningThread running(co);
+        CHECK(lua_resume(co, L, 0, &nres) == LUA_YIELD);
+        lua_pop(L, 1);
+    }
+    watchdog.Stop();
+
+    const std::string log = ReadLog();
+    CHECK(watchdog.HitchCount() == 1);
+    CHECK(log.find("phase=async") != std::string::npos);
+    CHECK(log.find("busy_in_co") != std::string::npos);
+    std::filesystem::remove(LogPath(), ec);
+}
+
+// 3. coroutine.wrap으로 직접 돌린 코루틴은 표시가 없어도 양보한 뒤 바깥에서 한 번은 잡힘
+static void TestUntrackedCoroutineHitch(lua_State* L) {
+    std::error_code ec;
+    std::filesystem::remove(LogPath(), ec);
+
+    HitchWatchdog watchdog;
+    watchdog.Start(L, TestConfig(), nullptr);
+    CallPhase(watchdog, L, "async", "run_co");
+    watchdog.Stop();
+
+    const std::string log = ReadLog();
+    CHECK(watchdog.HitchCount() == 1);
+    CHECK(log.find("phase=async") != std::string::npos);
+    CHECK(log.find("run_co") != std::string::npos);
+    std::filesystem::remove(LogPath(), ec);
+}
+
+// 4. 파일이 maxFileBytes를 넘으면 file -> file.1 -> file.2 로 밀리고 keepFiles개까지만 남음
+static void TestRotation(lua_State* L) {
+    std::error_code ec;
+    const std::string path = LogPath();
+    for (const char* suffix : { "", ".1", ".2", ".3" }) std::filesystem::remove(path + suffix, ec);
+
+    HitchWatchdog::Config cfg = TestConfig();
+    cfg.maxFileBytes = 64; // 보고서 하나만 써도 넘침
+    cfg.keepFiles = 3;
+
+    HitchWatchdog watchdog;
+    watchdog.Start(L, cfg, nullptr);
+    for (int i = 0; i < 4; i++) {
+        CallPhase(watchdog, L, "update", "slow_update");
+        // 감시 스레드가 이번 보고서를 쓰고 나서 다음 구간을 시작해야 파일 하나에 하나씩 들어감
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    watchdog.Stop();
+
+    CHECK(watchdog.HitchCount() == 4);
+    CHECK(std::filesystem::exists(path));
+    CHECK(std::filesystem::exists(path + ".1"));
+    CHECK(std::filesystem::exists(path + ".2"));
+    CHECK(!std::filesystem::exists(path + ".3"));
+    // 마지막 보고서는 그 뒤에 붙은 "ended after" 줄에 밀려 file.1에 있음
+    std::ifstream rotated(path + ".1");
+    std::stringstream ss;
+    ss << rotated.rdbuf();
+    CHECK(ss.str().find("phase=update") != std::string::npos);
+    CHECK(ReadLog().find("ended after") != std::string::npos);
+    for (const char* suffix : { "", ".1", ".2" }) std::filesystem::remove(path + suffix, ec);
+}
+
+int main() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    if (luaL_dostring(L, kScript) != LUA_OK) {
+        std::fprintf(stderr, "lua error: %s\n", lua_tostring(L, -1));
+        return 1;
+    }
+    TestSlowPhase(L);
+    TestCoroutineHitch(L);
+    TestUntrackedCoroutineHitch(L);
+    TestRotation(L);
+    lua_close(L);
+    return CheckResult("test_watchdog");
+}
@@ -0,0 +1,275 @@
+#include "tween.h"
+#include <cmath>
+
+// --- 이징 함수 (t: 0~1) ---
+namespace {
+constexpr float kPi = 3.14159265f;
+
+struct EaseLinear { static float Apply(float t) { return t; } };
+struct EaseQuadIn { static float Apply(float t) { return t * t; } };
+struct EaseQuadOut { static float Apply(float t) { return t * (2.0f - t); } };
+struct EaseQuadInOut {
+    static float Apply(float t) { return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t; }
+};
+struct EaseCubicIn { static float Apply(float t) { return t * t * t; } };
+struct EaseCubicOut { static float Apply(float t) { float u = t - 1.0f; return u * u * u + 1.0f; } };
+struct EaseCubicInOut {
+    static float Apply(float t) {
+        if (t < 0.5f) return 4.0f * t * t * t;
+        float u = 2.0f * t - 2.0f;
+        return 0.5f * u * u * u + 1.0f;
+    }
+};
+struct EaseSineIn { static float Apply(float t) { return 1.0f - cosf(t * kPi * 0.5f); } };
+struct EaseSineOut { static float Apply(float t) { return sinf(t * kPi * 0.5f); } };
+struct EaseSineInOut { static float Apply(float t) { return 0.5f * (1.0f - cosf(t * kPi)); } };
+struct EaseExpoIn { static float Apply(float t) { return t <= 0.0f ? 0.0f : exp2f(10.0f * t - 10.0f); } };
+struct EaseExpoOut { static float Apply(float t) { return t >= 1.0f ? 1.0f : 1.0f - exp2f(-10.0f * t); } };
+struct EaseExpoInOut {
+    static float Apply(float t) {
+        if (t <= 0.0f) return 0.0f;
+        if (t >= 1.0f) return 1.0f;
+        return t < 0.5f ? 0.5f * exp2f(20.0f * t - 10.0f) : 1.0f - 0.5f * exp2f(-20.0f * t + 10.0f);
+    }
+};
+constexpr float kBack = 1.70158f;
+struct EaseBackIn { static float Apply(float t) { return t * t * ((kBack + 1.0f) * t - kBack); } };
+struct EaseBackOut {
+    static float Apply(float t) { float u = t - 1.0f; return u * u * ((kBack + 1.0f) * u + kBack) + 1.0f; }
+};
+struct EaseBackInOut {
+    static float Apply(float t) {
+        constexpr float s = kBack * 1.525f;
+        if (t < 0.5f) {
+            float u = 2.0f * t;
+            return 0.5f * u * u * ((s + 1.0f) * u - s);
+        }
+        float u = 2.0f * t - 2.0f;
+        return 0.5f * (u * u * ((s + 1.0f) * u + s) + 2.0f);
+    }
+};
+struct EaseElasticOut {
+    static float Apply(float t) {
+        if (t <= 0.0f) return 0.0f;
+        if (t >= 1.0f) return 1.0f;
+        return exp2f(-10.0f * t) * sinf((t * 10.0f - 0.75f) * (2.0f * kPi / 3.0f)) + 1.0f;
+    }
+};
+struct EaseBounceOut {
+    static float Apply(float t) {
+        constexpr float n = 7.5625f, d = 2.75f;
+        if (t < 1.0f / d) return n * t * t;
+        if (t < 2.0f / d) { t -= 1.5f / d; return n * t * t + 0.75f; }
+        if (t < 2.5f / d) { t -= 2.25f / d; return n * t * t + 0.9375f; }
+        t -= 2.625f / d;
+        return n * t * t + 0.984375f;
+    }
+};
+
+// 같은 이징끼리 모인 그룹에 대해 한 번에 계산 (이징마다 따로 인스턴스화되어 분기 없이 인라인)
+template <class E, class G>
+void EaseKernel(const std::vector<uint32_t>& slots, std::vector<G>& groups) {
+    for (uint32_t slot : slots) {
+        G& g = groups[slot];
+        float t = g.duration > 0.0f ? g.elapsed / g.duration : 1.0f;
+        g.eased = E::Apply(t < 1.0f ? t : 1.0f);
+    }
+}
+
+struct EaseName {
+    const char* name;
+    Ease ease;
+};
+constexpr EaseName kEaseNames[] = {
+    { "linear", Ease::Linear },
+    { "quadIn", Ease::QuadIn }, { "quadOut", Ease::QuadOut }, { "quadInOut", Ease::QuadInOut },
+    { "cubicIn", Ease::CubicIn }, { "cubicOut", Ease::CubicOut }, { "cubicInOut", Ease::CubicInOut },
+    { "sineIn", Ease::SineIn }, { "sineOut", Ease::SineOut }, { "sineInOut", Ease::SineInOut },
+    { "expoIn", Ease::ExpoIn }, { "expoOut", Ease::ExpoOut }, { "expoInOut", Ease::ExpoInOut },
+    { "backIn", Ease::BackIn }, { "backOut", Ease::BackOut }, { "backInOut", Ease::BackInOut },
+    { "elasticOut", Ease::ElasticOut }, { "bounceOut", Ease::BounceOut },
+};
+}
+
+bool ParseEase(std::string_view name, Ease& out) {
+    for (const auto& e : kEaseNames) {
+        if (name == e.name) {
+            out = e.ease;
+            return true;
+        }
+    }
+    return false;
+}
+
+TweenGroupHandle TweenPool::CreateGroup(float durationMs, float delayMs, Ease ease, const TweenGroupHandle* after) {
+    uint32_t slot;
+    if (!freeGroups.empty()) {
+        slot = freeGroups.back();
+        freeGroups.pop_back();
+    }
+    else {
+        slot = (uint32_t)groups.size();
+        groups.emplace_back();
+    }
+
+    Group& g = groups[slot];
+    g.elapsed = 0.0f;
+    g.duration = durationMs > 0.0f ? durationMs : 0.0f;
+    g.delay = delayMs > 0.0f ? delayMs : 0.0f;
+    g.eased = 0.0f;
+    g.ease = ease < Ease::Count ? ease : Ease::Linear;
+    g.justStarted = false;
+    g.hasAfter = after && IsAlive(*after);
+    if (g.hasAfter) g.after = *after;
+    g.state = g.hasAfter ? State::Waiting : State::Delayed;
+    return { slot, g.generation };
+}
+
+void TweenPool::AddTween(TweenGroupHandle h, float toValue, uint32_t targetIndex) {
+    if (!IsAlive(h)) return;
+    from.push_back(0.0f);
+    to.push_back(toValue);
+    value.push_back(0.0f);
+    group.push_back(h.slot);
+    target.push_back(targetIndex);
+}
+
+bool TweenPool::IsAlive(TweenGroupHandle h) const {
+    if (h.slot >= groups.size()) return false;
+    const Group& g = groups[h.slot];
+    return g.generation == h.generation && g.state != State::Free && g.state != State::Cancelled;
+}
+
+bool TweenPool::Cancel(TweenGroupHandle h) {
+    if (!IsAlive(h)) return false;
+    groups[h.slot].state = State::Cancelled;
+
+    // 이 그룹을 기다리던 그룹들도 취소
+    for (uint32_t s = 0; s < groups.size(); s++) {
+        const Group& g = groups[s];
+        if (g.state == State::Waiting && g.after.slot == h.slot && g.after.generation == h.generation)
+            Cancel({ s, g.generation });
+    }
+    return true;
+}
+
+void TweenPool::Advance(float dtms) {
+    for (Group& g : groups) {
+        if (g.state == State::Delayed) {
+            g.delay -= dtms;
+            if (g.delay <= 0.0f) {
+                g.state = State::Running;
+                g.elapsed = -g.delay; // 지연을 넘긴 만큼은 이미 진행
+                g.justStarted = true;
+            }
+        }
+        else if (g.state == State::Running) {
+            g.elapsed += dtms;
+        }
+    }
+
+    started.clear();
+    active.clear();
+    for (uint32_t i = 0; i < (uint32_t)to.size(); i++) {
+        const Group& g = groups[group[i]];
+        if (g.state != State::Running) continue;
+        active.push_back(i);
+        if (g.justStarted) started.push_back(i);
+    }
+}
+
+void TweenPool::Evaluate() {
+    using Kernel = void (*)(const std::vector<uint32_t>&, std::vector<Group>&);
+    static constexpr Kernel kKernels[(size_t)Ease::Count] = {
+        EaseKernel<EaseLinear, Group>,
+        EaseKernel<EaseQuadIn, Group>, EaseKernel<EaseQuadOut, Group>, EaseKernel<EaseQuadInOut, Group>,
+        EaseKernel<EaseCubicIn, Group>, EaseKernel<EaseCubicOut, Group>, EaseKernel<EaseCubicInOut, Group>,
+        EaseKernel<EaseSineIn, Group>, EaseKernel<EaseSineOut, Group>, EaseKernel<EaseSineInOut, Group>,
+        EaseKernel<EaseExpoIn, Group>, EaseKernel<EaseExpoOut, Group>, EaseKernel<EaseExpoInOut, Group>,
+        EaseKernel<EaseBackIn, Group>, EaseKernel<EaseBackOut, Group>, EaseKernel<EaseBackInOut, Group>,
+        EaseKernel<EaseElasticOut, Group>, EaseKernel<EaseBounceOut, Group>,
+    };
+
+    // 1. 실행 중인 그룹을 이징별로 모아서 커널 하나씩 실행
+    for (auto& b : buckets) b.clear();
+    for (uint32_t s = 0; s < groups.size(); s++) {
+        if (groups[s].state == State::Running) buckets[(size_t)groups[s].ease].push_back(s);
+    }
+    for (size_t e = 0; e < (size_t)Ease::Count; e++) {
+        if (!buckets[e].empty()) kKernels[e](buckets[e], groups);
+    }
+
+    // 2. 트윈 값 = from + (to - from) * eased
+    for (uint32_t i : active) {
+        value[i] = from[i] + (to[i] - from[i]) * groups[group[i]].eased;
+    }
+}
+
+void TweenPool::Collect(std::vector<uint32_t>& finishedGroups, std::vector<uint32_t>& cancelledGroups,
+    std::vector<uint32_t>& freedTargets) {
+    // 1. 끝난 그룹 표시, 기다리던 그룹은 지연을 세기 시작
+    for (uint32_t s = 0; s < groups.size(); s++) {
+        Group& g = groups[s];
+        g.justStarted = false;
+        if (g.state == State::Running && g.elapsed >= g.duration) {
+            g.state = State::Finished;
+            finishedGroups.push_back(s);
+        }
+        else if (g.state == State::Cancelled) {
+            cancelledGroups.push_back(s);
+        }
+    }
+    for (Group& g : groups) {
+        if (g.state != State::Waiting) continue;
+        const Group& prev = groups[g.after.slot];
+        if (prev.generation == g.after.generation && prev.state == State::Finished) g.state = State::Delayed;
+    }
+
+    // 2. 끝난 그룹의 트윈 제거 (swap-remove)
+    for (uint32_t i = 0; i < (uint32_t)to.size();) {
+        const State st = groups[group[i]].state;
+        if (st != State::Finished && st != State::Cancelled) {
+            i++;
+            continue;
+        }
+        freedTargets.push_back(target[i]);
+        const size_t last = to.size() - 1;
+        from[i] = from[last];
+        to[i] = to[last];
+        value[i] = value[last];
+        group[i] = group[last];
+        target[i] = target[last];
+        from.pop_back();
+        to.pop_back();
+        value.pop_back();
+        group.pop_back();
+        target.pop_back();
+    }
+
+    // 3. 그룹 슬롯 반환
+    for (uint32_t s = 0; s < groups.size(); s++) {
+        Group& g = groups[s];
+        if (g.state != State::Finished && g.state != State::Cancelled) continue;
+        g.state = State::Free;
+        g.generation++;
+        freeGroups.push_back(s);
+    }
+    started.clear();
+    active.clear();
+}
+
+void TweenPool::Clear() {
+    from.clear();
+    to.clear();
+    value.clear();
+    group.clear();
+    target.clear();
+    for (Group& g : groups) {
+        if (g.state != State::Free) g.generation++;
+        g.state = State::Free;
+    }
+    freeGroups.clear();
+    for (uint32_t s = (uint32_t)groups.size(); s-- > 0;) freeGroups.push_back(s);
+    started.clear();
+    active.clear();
+}
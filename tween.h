@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 트윈 풀 (플랫폼 독립, Lua 의존성 없음)
+// 트윈 값(from/to/value/그룹/타깃)은 SoA로 빈틈 없이 두고,
+// 같은 시간축을 공유하는 트윈 묶음(그룹)이 경과 시간, 지연, 이징, 순서(after)를 가집니다.
+// 이징은 종류별로 그룹을 모아서 템플릿으로 특수화된 커널 하나씩으로 계산합니다.
+// 타깃은 엔진 쪽 인덱스(uint32_t)로만 들고 있어서 읽고 쓰는 것은 엔진이 한 번에 처리합니다.
+enum class Ease : uint8_t {
+    Linear,
+    QuadIn, QuadOut, QuadInOut,
+    CubicIn, CubicOut, CubicInOut,
+    SineIn, SineOut, SineInOut,
+    ExpoIn, ExpoOut, ExpoInOut,
+    BackIn, BackOut, BackInOut,
+    ElasticOut, BounceOut,
+    Count
+};
+bool ParseEase(std::string_view name, Ease& out);
+
+struct TweenGroupHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+class TweenPool {
+public:
+    // after가 살아 있으면 그 그룹이 끝난 뒤 delayMs를 기다렸다가 시작합니다.
+    TweenGroupHandle CreateGroup(float durationMs, float delayMs, Ease ease, const TweenGroupHandle* after = nullptr);
+    void AddTween(TweenGroupHandle group, float to, uint32_t target);
+    bool IsAlive(TweenGroupHandle group) const;
+    // 뒤에 이어진(after) 그룹도 같이 취소됩니다. 실제 정리는 Collect에서
+    bool Cancel(TweenGroupHandle group);
+
+    // 1. 시간 진행. 이번 프레임에 시작한 트윈은 Started()에 담기며 엔진이 SetFrom으로 현재 값을 채웁니다.
+    void Advance(float dtms);
+    const std::vector<uint32_t>& Started() const { return started; }
+    void SetFrom(uint32_t tween, float v) { from[tween] = v; }
+
+    // 2. 이징 적용. Active()의 트윈들은 Value()를 타깃에 써야 합니다.
+    void Evaluate();
+    const std::vector<uint32_t>& Active() const { return active; }
+    float Value(uint32_t tween) const { return value[tween]; }
+    uint32_t Target(uint32_t tween) const { return target[tween]; }
+
+    // 3. 끝난/취소된 그룹과 그 트윈 정리. 트윈 인덱스는 여기서 바뀝니다.
+    void Collect(std::vector<uint32_t>& finishedGroups, std::vector<uint32_t>& cancelledGroups,
+        std::vector<uint32_t>& freedTargets);
+
+    void Clear();
+    size_t TweenCount() const { return to.size(); }
+    size_t GroupCount() const { return groups.size() - freeGroups.size(); }
+
+private:
+    enum class State : uint8_t { Free, Waiting, Delayed, Running, Finished, Cancelled };
+
+    struct Group {
+        float elapsed = 0.0f, duration = 0.0f, delay = 0.0f;
+        float eased = 0.0f;
+        Ease ease = Ease::Linear;
+        State state = State::Free;
+        bool justStarted = false;
+        uint32_t generation = 0;
+        TweenGroupHandle after;
+        bool hasAfter = false;
+    };
+
+    // --- SoA 트윈 데이터 ---
+    std::vector<float> from, to, value;
+    std::vector<uint32_t> group;   // 그룹 슬롯
+    std::vector<uint32_t> target;  // 엔진 타깃 인덱스
+
+    std::vector<Group> groups;
+    std::vector<uint32_t> freeGroups;
+
+    std::vector<uint32_t> started, active;
+    std::vector<uint32_t> buckets[(size_t)Ease::Count]; // 이징별 실행 중 그룹 슬롯
+};
@@ -0,0 +1,215 @@
+#include "watchdog.h"
+#include <lua.hpp>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <csignal>
+#endif
+
+static std::atomic<HitchWatchdog*> s_activeWatchdog{ nullptr };
+
+#if !defined(_WIN32)
+// 훅을 거는 시그널. 핸들러는 lua_sethook만 부릅니다. (lua.c의 laction과 같음)
+static constexpr int kArmSignal = SIGUSR2;
+#endif
+
+double HitchWatchdog::NowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void HitchWatchdog::Start(lua_State* state, const Config& cfg, Describe desc) {
+    Stop();
+    L = state;
+    config = cfg;
+    describe = std::move(desc);
+    stopping = false;
+    reportedSeq = 0;
+    armedSeq.store(0);
+#if defined(_WIN32)
+    HANDLE handle = nullptr;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle,
+        THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, 0);
+    mainThread = handle;
+#else
+    mainThread = pthread_self();
+    struct sigaction sa = {};
+    sa.sa_handler = [](int) { ArmHook(); };
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(kArmSignal, &sa, nullptr);
+#endif
+    s_activeWatchdog = this;
+    thread = std::thread(&HitchWatchdog::Run, this);
+}
+
+void HitchWatchdog::Stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+
+    // 걸어 둔 훅이 아직 안 불렸으면 여기서 뺍니다. 코루틴에 남은 훅은 다음 명령에서 스스로 빠집니다.
+    lua_sethook(L, nullptr, 0, 0);
+    s_activeWatchdog = nullptr;
+    L = nullptr;
+#if defined(_WIN32)
+    CloseHandle(mainThread);
+    mainThread = nullptr;
+#endif
+}
+
+void HitchWatchdog::Enter(const char* name) {
+    if (depth++ > 0) return;
+    phaseStartMs.store(NowMs(), std::memory_order_relaxed);
+    phase.store(name, std::memory_order_relaxed);
+    phaseSeq.fetch_add(1, std::memory_order_release);
+}
+
+void HitchWatchdog::Leave() {
+    if (depth == 0 || --depth > 0) return;
+
+    // 보고서를 남긴 구간이면 실제로 걸린 시간을 덧붙임
+    const uint64_t seq = phaseSeq.load(std::memory_order_relaxed);
+    if (reportedSeq == seq) {
+        char line[96];
+        snprintf(line, sizeof(line), "  ended after %.1f ms\n", NowMs() - phaseStartMs.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(line);
+    }
+    phase.store(nullptr, std::memory_order_relaxed);
+    phaseSeq.fetch_add(1, std::memory_order_release);
+}
+
+// 메인 상태와 실행 중인 코루틴에 다음 명령에서 불리는 훅을 겁니다.
+// lua_sethook은 lua.c처럼 비동기(시그널)로 불러도 되는 함수라 메인 스레드가 멈춘 상태에서만 부릅니다.
+void HitchWatchdog::ArmHook() {
+    HitchWatchdog* self = s_activeWatchdog.load(std::memory_order_relaxed);
+    if (!self) return;
+    lua_sethook(self->L, &HitchWatchdog::Hook, LUA_MASKCOUNT, 1);
+    lua_State* co = runningThread.load(std::memory_order_relaxed);
+    if (co && co != self->L) lua_sethook(co, &HitchWatchdog::Hook, LUA_MASKCOUNT, 1);
+}
+
+void HitchWatchdog::RequestHook() {
+#if defined(_WIN32)
+    if (SuspendThread(mainThread) == (DWORD)-1) return;
+    // SuspendThread는 비동기라 컨텍스트를 읽어서 실제로 멈췄는지 확인합니다.
+    CONTEXT ctx = {};
+    ctx.ContextFlags = CONTEXT_CONTROL;
+    GetThreadContext(mainThread, &ctx);
+    ArmHook();
+    ResumeThread(mainThread);
+#else
+    pthread_kill(mainThread, kArmSignal);
+#endif
+}
+
+// RequestHook 다음 명령에서 메인 스레드가 실행합니다. L은 지금 실행 중인 스레드(코루틴일 수 있음)
+void HitchWatchdog::Hook(lua_State* L, lua_Debug*) {
+    lua_sethook(L, nullptr, 0, 0); // 한 번 불리면 빠짐 (평소에는 훅 없이 실행)
+    HitchWatchdog* self = s_activeWatchdog.load(std::memory_order_relaxed);
+    if (!self) return;
+    const uint64_t seq = self->armedSeq.load(std::memory_order_acquire);
+    if (seq == 0 || seq == self->reportedSeq) return;
+
+    // 감시 스레드가 표시한 뒤에 구간이 끝났거나, 다른 상태의 코루틴이 남긴 훅이면 무시
+    const char* phaseName = self->phase.load(std::memory_order_relaxed);
+    if (!phaseName || self->phaseSeq.load(std::memory_order_acquire) != seq) return;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    const bool sameState = lua_tothread(L, -1) == self->L;
+    lua_pop(L, 1);
+    if (!sameState) return;
+    self->reportedSeq = seq;
+
+    using namespace std::chrono;
+    const auto now = system_clock::now();
+    const auto day = floor<days>(now);
+    const year_month_day ymd{ day };
+    const hh_mm_ss<seconds> tod{ duration_cast<seconds>(now - day) };
+
+    char header[192];
+    snprintf(header, sizeof(header), "=== hitch %04d-%02u-%02u %02d:%02d:%02d UTC phase=%s elapsed=%.1fms budget=%.0fms\n",
+        (int)ymd.year(), (unsigned)ymd.month(), (unsigned)ymd.day(),
+        (int)tod.hours().count(), (int)tod.minutes().count(), (int)tod.seconds().count(),
+        phaseName, NowMs() - self->phaseStartMs.load(std::memory_order_relaxed), self->config.budgetMs);
+
+    std::string report = header;
+    if (self->describe) report += self->describe(L) + "\n";
+    luaL_traceback(L, L, nullptr, 0);
+    report += lua_tostring(L, -1);
+    report += "\n";
+    lua_pop(L, 1);
+
+    self->hitches.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->pending.push_back(std::move(report));
+    }
+    self->wake.notify_one();
+}
+
+void HitchWatchdog::Run() {
+    // 예산의 1/4 간격으로 확인 (너무 촘촘하면 감시 스레드가 CPU를 씀)
+    const auto poll = std::chrono::duration<double, std::milli>(config.budgetMs > 8.0 ? config.budgetMs / 4.0 : 2.0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wake.wait_for(lock, poll);
+
+        if (!pending.empty()) {
+            std::vector<std::string> reports;
+            reports.swap(pending);
+            lock.unlock();
+            Write(reports);
+            lock.lock();
+        }
+
+        // seqlock처럼 앞뒤로 같은 구간인지 확인
+        const uint64_t seq = phaseSeq.load(std::memory_order_acquire);
+        const char* current = phase.load(std::memory_order_relaxed);
+        const double start = phaseStartMs.load(std::memory_order_relaxed);
+        if (!current || seq != phaseSeq.load(std::memory_order_acquire)) continue;
+        if (armedSeq.load() == seq || NowMs() - start < config.budgetMs) continue;
+
+        // 표시를 남기고 훅을 겁니다. 보고서는 훅 안에서 메인 스레드가 만듭니다.
+        armedSeq.store(seq, std::memory_order_release);
+        RequestHook();
+    }
+
+    std::vector<std::string> reports;
+    reports.swap(pending);
+    lock.unlock();
+    Write(reports);
+}
+
+void HitchWatchdog::Write(const std::vector<std::string>& reports) {
+    if (reports.empty()) return;
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    // file -> file.1 -> file.2 ... (keepFiles개까지)
+    if (fs::exists(config.file, ec) && fs::file_size(config.file, ec) >= config.maxFileBytes) {
+        for (int i = config.keepFiles - 1; i >= 1; i--) {
+            const std::string from = i == 1 ? config.file : config.file + "." + std::to_string(i - 1);
+            const std::string to = config.file + "." + std::to_string(i);
+            if (!fs::exists(from, ec)) continue;
+            fs::remove(to, ec);
+            fs::rename(from, to, ec);
+        }
+        if (config.keepFiles <= 1) fs::remove(config.file, ec);
+    }
+
+    std::ofstream file(config.file, std::ios::app);
+    for (const auto& r : reports) {
+        file << r;
+        printf("[Watchdog] %s", r.c_str());
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+struct lua_State;
+struct lua_Debug;
+
+// 프레임 히치 감시 (Lua C API만 사용, 훅을 거는 부분만 Win32/POSIX로 나뉨)
+// 메인 스레드는 Lua 호출 구간마다 Enter/Leave로 단계 이름과 시작 시간만 남깁니다.
+// 평소에는 훅이 없습니다. (카운트 훅이 있으면 luaV_execute가 명령마다 추적 경로를 탐)
+// 감시 스레드가 예산을 넘긴 구간을 보면 armedSeq를 기록하고, lua.c의 시그널 처리처럼
+// 메인 스레드를 멈춘 상태(Windows: SuspendThread) 또는 시그널 핸들러(POSIX) 안에서 lua_sethook으로
+// 다음 명령에 걸리는 훅을 겁니다. 훅은 실행 중인 스레드의 traceback을 떠서 넘기고 스스로 빠집니다.
+class HitchWatchdog {
+public:
+    struct Config {
+        double budgetMs = 100.0;
+        std::string file = "hitch.log";
+        size_t maxFileBytes = 256 * 1024; // 넘으면 file.1, file.2 ... 로 밀어냄
+        int keepFiles = 3;
+    };
+    // 훅 안(메인 스레드)에서 불려 GC/태스크 상태 같은 부가 정보를 한 줄로 돌려줍니다.
+    using Describe = std::function<std::string(lua_State*)>;
+
+    ~HitchWatchdog() { Stop(); }
+
+    // 둘 다 메인 스레드에서 호출합니다. (Start 전에 만들어진 코루틴은 감시되지 않음)
+    void Start(lua_State* L, const Config& config, Describe describe);
+    void Stop();
+    bool Enabled() const { return thread.joinable(); }
+    const Config& GetConfig() const { return config; }
+    uint64_t HitchCount() const { return hitches.load(std::memory_order_relaxed); }
+
+    // 메인 스레드 전용. 중첩되면 바깥 구간만 잽니다.
+    void Enter(const char* phase);
+    void Leave();
+
+    // 지금 Lua를 실행 중인 스레드 (nullptr이면 메인 상태). 코루틴을 재개하는 쪽이 HitchRunningThread로 표시합니다.
+    static inline std::atomic<lua_State*> runningThread{ nullptr };
+
+private:
+    static void Hook(lua_State* L, lua_Debug* ar);
+    static void ArmHook(); // 메인 스레드가 멈춰 있거나 시그널 핸들러 안에서만
+    static double NowMs();
+    void Run();
+    void RequestHook();    // 감시 스레드에서
+    void Write(const std::vector<std::string>& reports);
+
+    Config config;
+    Describe describe;
+    lua_State* L = nullptr;
+#if defined(_WIN32)
+    void* mainThread = nullptr;           // SuspendThread용 핸들
+#else
+    pthread_t mainThread{};
+#endif
+
+    // 메인 스레드가 쓰고 감시 스레드가 읽음 (phaseSeq로 일관성 확인)
+    std::atomic<const char*> phase{ nullptr };
+    std::atomic<double> phaseStartMs{ 0.0 };
+    std::atomic<uint64_t> phaseSeq{ 0 };
+    std::atomic<uint64_t> armedSeq{ 0 };  // 감시 스레드가 보고를 요청한 구간
+    std::atomic<uint64_t> hitches{ 0 };
+    int depth = 0;                        // 메인 스레드 전용
+    uint64_t reportedSeq = 0;             // 메인 스레드 전용
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::vector<std::string> pending;     // 파일에 쓸 보고서
+};
+
+// 코루틴을 lua_resume 하는 동안 감시 대상을 그 코루틴으로 바꿉니다. (AsyncScheduler::Resume)
+// coroutine.resume/wrap으로 직접 돌린 코루틴은 알 수 없어서, 그 안에서 멈추면 양보한 뒤의 바깥 스택이 잡힙니다.
+class HitchRunningThread {
+public:
+    explicit HitchRunningThread(lua_State* co) : prev(HitchWatchdog::runningThread.exchange(co)) {}
+    ~HitchRunningThread() { HitchWatchdog::runningThread.store(prev); }
+    HitchRunningThread(const HitchRunningThread&) = delete;
+    HitchRunningThread& operator=(const HitchRunningThread&) = delete;
+
+private:
+    lua_State* prev;
+};
+
+// CALL_LUA_FUNC 등에서 쓰는 구간 표시. 감시가 꺼져 있으면 bool 확인 하나로 끝납니다.
+class HitchPhase {
+public:
+    HitchPhase(HitchWatchdog& watchdog, const char* name)
+        : watchdog(watchdog), active(watchdog.Enabled()) {
+        if (active) watchdog.Enter(name);
+    }
+    ~HitchPhase() {
+        if (active) watchdog.Leave();
+    }
+    HitchPhase(const HitchPhase&) = delete;
+    HitchPhase& operator=(const HitchPhase&) = delete;
+
+private:
+    HitchWatchdog& watchdog;
+    bool active;
+};